@@ -1,11 +1,26 @@
 #include "Application.hpp"
 #include "../gfx/Mesh.hpp"
 #include "../gfx/Texture.hpp"
+#include "../gfx/ChunkMesher.hpp"
 #include "../world/TerrainGen.hpp"
+#include "../world/BlockRegistry.hpp"
+#include "../mem/Arena.hpp"
+#include "../mem/Stats.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
 #include <array>
+#include <thread>
+#include <vector>
+
+static const glm::vec3 kPlayerHalfExtents(0.3f, 0.9f, 0.3f);
+static constexpr float PLAYER_EYE = 0.7f; // eye height above the box centre
+static constexpr float PLAYER_JUMP_SPEED = 9.0f; // blocks/s, clears one block
 
 static const char* kGuiVS = R"(
 #version 330 core
@@ -28,7 +43,12 @@ void main() {
 }
 )";
 
-Application::Application(int width, int height, const char* title) {
+Application::Application(int width, int height, const char* title, bool headless) : headless_(headless) {
+#if !defined(__APPLE__) && defined(GLFW_PLATFORM_NULL)
+    // No display server at all (CI box): GLFW 3.4's null platform + OSMesa gives a pure software context
+    bool noDisplay = !std::getenv("DISPLAY") && !std::getenv("WAYLAND_DISPLAY");
+    if (headless_ && noDisplay) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
     if (!glfwInit()) throw std::runtime_error("GLFW init failed"); // Initialize GLFW
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3); // OpenGL version 3._
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3); // OpenGL version _.3 -> makes 3.3
@@ -36,29 +56,38 @@ Application::Application(int width, int height, const char* title) {
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // required for macOS
 #endif
-    window_ = glfwCreateWindow(width, height, title, nullptr, nullptr); // creates a window
-    glfwMakeContextCurrent(window_); // specify the above window as the current context
-    glfwSwapInterval(1); // the number of screen updates to wait from the time glfwSwapBuffers was called before swapping the buffers and returning. Sets framerate to monitor refresh rate
-    input_ = std::make_unique<Input>(window_);
-    tex_[0].load("assets/tile.png");
-    tex_[1].load("assets/turf.png");
-    tex_[2].load("assets/cardboard.png");
-    crosshairTex_.load("assets/crosshair.png");
-    glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_DISABLED); // Hide and disable mouse cursor when in the window
+    if (headless_) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); // the window only exists to own a GL context
+#if !defined(__APPLE__) && defined(GLFW_PLATFORM_NULL)
+        if (glfwGetPlatform() == GLFW_PLATFORM_NULL) glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
+    window_.handle = glfwCreateWindow(width, height, title, nullptr, nullptr); // creates a window
+    if (!window_.handle) throw std::runtime_error("GLFW window/context creation failed");
+    glfwMakeContextCurrent(window_.handle); // specify the above window as the current context
+    glfwSwapInterval(headless_ ? 0 : 1); // the number of screen updates to wait from the time glfwSwapBuffers was called before swapping the buffers and returning. Sets framerate to monitor refresh rate
+    input_ = std::make_unique<Input>(window_.handle);
+    const std::vector<std::string> blockTextureFiles(std::begin(kBlockTextureFiles), std::end(kBlockTextureFiles));
+    if (!blockTextures_.beginLoad(blockTextureFiles, kBlockTexturePack)) std::fprintf(stderr, "failed to load block textures\n");
+    if (headless_) blockTextures_.finishLoad(); // benchmarks and replays compare frames, so textures must be there from the first
+    crosshairTex_.load("assets/Crosshair.png");
+    if (headless_) offscreen_ = std::make_unique<Framebuffer>(width, height);
+    setCursorCaptured(!headless_);
     static const char* kVS = R"(
     #version 330 core
     layout (location = 0) in vec3 aPos;
     layout (location = 1) in vec3 instanceOffset;
     layout (location = 2) in vec2 aUV;
-    layout (location = 3) in int texIndex;
+    layout (location = 3) in int faceLayers; // 5 bits per face, see BlockRegistry.hpp
     out vec2 vUV;
-    flat out int vTexIndex;
+    flat out int vLayer;
 
     uniform mat4 uVP;
     void main() {
         vec3 pos = aPos + instanceOffset;
         vUV = aUV;
-        vTexIndex = texIndex;
+        vLayer = (faceLayers >> (5 * (gl_VertexID / 4))) & 31; // CubeMesh has four vertices per face
+
         gl_Position = uVP * vec4(pos, 1.0);
     }
     )";
@@ -66,11 +95,11 @@ Application::Application(int width, int height, const char* title) {
     static const char* kFS = R"(
     #version 330 core
     in vec2 vUV;
-    flat in int vTexIndex;
-    uniform sampler2D uTex[3];
+    flat in int vLayer;
+    uniform sampler2DArray uTex;
     out vec4 FragColor;
     void main() {
-        FragColor = texture(uTex[vTexIndex], vUV);
+        FragColor = texture(uTex, vec3(vUV, float(vLayer)));
     }
     )";
 
@@ -78,30 +107,31 @@ Application::Application(int width, int height, const char* title) {
     instanceVBO_.init();
     renderer_ = std::make_unique<Renderer>(kVS, kFS, *cube_);
     renderer_->setupAttributes(*cube_, instanceVBO_);
+    renderer_->setGpuCulling(true); // falls back to CPU culling below GL 4.3
     
     glUseProgram(renderer_->shader().id());
-    glUniform1iv(glGetUniformLocation(renderer_->shader().id(), "uTex"), 3, (int[]){0,1,2});
+    glUniform1i(glGetUniformLocation(renderer_->shader().id(), "uTex"), 0);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex_[0].texID);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, tex_[1].texID);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, tex_[2].texID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, blockTextures_.texID);
     camera_ = std::make_unique<Camera>();
-    glfwSetWindowUserPointer(window_, camera_.get());
-    world_ = std::make_unique<World>(makeTerrain(32, 4));
-    renderer_->buildInstanceBuffer(world_->blocks(), instanceVBO_);
-    needUpload_ = true;
+    glfwSetWindowUserPointer(window_.handle, camera_.get());
+    world_ = std::make_unique<World>(makeTerrain(32, 4, kDefaultTerrainSeed));
+    ticker_ = std::make_unique<BlockTicker>(*world_);
+    spawnPlayer();
     initHUD();
     lastTime_ = glfwGetTime();
 }
 
 Application::~Application() {
+    blockTextures_.finishLoad(); // its loader threads may still be writing into a mapped GL buffer
     if (hudEbo_) glDeleteBuffers(1, &hudEbo_);
     if (hudVbo_) glDeleteBuffers(1, &hudVbo_);
     if (hudVao_) glDeleteVertexArrays(1, &hudVao_);
-    glfwDestroyWindow(window_);
-    glfwTerminate();
+} // the GL-owning members are destroyed next, window_ last
+
+Application::Window::~Window() {
+    if (handle) glfwDestroyWindow(handle);
+    glfwTerminate(); // also runs when the constructor threw after glfwInit()
 }
 
 void Application::initHUD() {
@@ -128,36 +158,213 @@ void Application::initHUD() {
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(idx), idx, GL_STATIC_DRAW);
 
     glBindVertexArray(0);
+    statsText_ = std::make_unique<TextOverlay>();
+}
+
+void Application::setGpuCulling(bool enable) {
+    renderer_->setGpuCulling(enable);
+}
+
+void Application::startRecording(const std::string& path) {
+    recorder_ = std::make_unique<SessionRecorder>(path, kDefaultTerrainSeed, cursorCaptured_);
+}
+
+void Application::startReplay(const std::string& path, bool fast) {
+    player_ = std::make_unique<SessionPlayer>(path);
+    fastReplay_ = fast;
+    if (fast) glfwSwapInterval(0);
+    setCursorCaptured(player_->cursorCaptured()); // a headless replay would otherwise drop mouse look until the first click
+    world_ = std::make_unique<World>(makeTerrain(32, 4, player_->terrainSeed()));
+    ticker_ = std::make_unique<BlockTicker>(*world_);
+    spawnPlayer();
+}
+
+void Application::connect(const std::string& host, uint16_t port) {
+    client_ = std::make_unique<WorldClient>(host, port);
+    ticker_.reset(); // the server runs the simulation
+    world_ = std::make_unique<World>(); // filled in as the server streams chunks
+    spawnPlayer();
+}
+
+void Application::enableAutosave(const std::string& dir) {
+    if (client_) throw std::runtime_error("Autosave belongs on the server when connected to one");
+    size_t loaded = loadSavedChunks(dir, *world_);
+    if (loaded) std::printf("loaded %zu saved chunks from %s\n", loaded, dir.c_str());
+    for (const auto& [coord, chunk] : world_->chunks()) ticker_->wakeChunk(coord); // resume flows saved mid-way
+    autosaver_ = std::make_unique<Autosaver>(dir);
+}
+
+void Application::autosave() {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto snapshot = world_->snapshotUnsaved();
+    size_t chunks = snapshot.size();
+    autosaver_->submit(std::move(snapshot));
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    if (chunks) std::printf("autosave: handed %zu chunks to the writer in %.1f us\n", chunks, us);
+    lastAutosave_ = simTime_;
+}
+
+void Application::stepSimulation() {
+    if (!ticker_) return;
+    // Fixed rate on simulated time, so a replayed session runs exactly the same block ticks
+    constexpr double period = 1.0 / BlockTicker::TICK_RATE;
+    while (simTime_ - blockTickTime_ >= period) {
+        ticker_->tick();
+        blockTickTime_ += period;
+    }
 }
 
 void Application::run() {
-    while (!glfwWindowShouldClose(window_)) {
-        double now = glfwGetTime();
-        float dt = float(now - lastTime_);
-        lastTime_ = now;
+    using Clock = std::chrono::steady_clock;
+    const auto wallStart = Clock::now();
+    uint64_t divergences = 0, firstDivergence = 0;
+    if (headless_) offscreen_->bind();
+    while (!glfwWindowShouldClose(window_.handle)) {
         glfwPollEvents();
-        input_->update();
-        processInput(dt);
+        float dt;
+        SessionTick recorded;
+        if (player_) {
+            if (!player_->next(recorded)) break;
+            dt = recorded.dt;
+            input_->inject(recorded.input);
+        } else {
+            double now = glfwGetTime();
+            dt = float(now - lastTime_);
+            lastTime_ = now;
+            input_->update();
+        }
+        simTime_ += dt;
+        tickEdits_.clear();
+        if (client_) receiveChunks();
+        processInput();
+        stepPhysics(dt);
         handleMouseLook();
         handleBlockActions();
-        int w, h; glfwGetFramebufferSize(window_, &w, &h);
-        float aspect = (h>0) ? (float)w / (float)h : 1.0f;
-        glm::mat4 v = camera_->view();
-        glm::mat4 p = camera_->proj(aspect);
-        glm::mat4 vp = p * v;
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glViewport(0,0,w,h);
-        glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        if (needUpload_) {
-            renderer_->buildInstanceBuffer(world_->blocks(), instanceVBO_);
-            needUpload_ = false;
+        stepSimulation();
+        if (autosaver_ && simTime_ - lastAutosave_ >= AUTOSAVE_INTERVAL_SECONDS) autosave();
+
+        SessionTick tick{dt, input_->capture(), camera_->pos, camera_->yaw, camera_->pitch, tickEdits_};
+        if (recorder_) recorder_->write(tick);
+        if (player_) {
+            auto sameEdit = [](const EditCommand& a, const EditCommand& b) { return a.place == b.place && a.pos == b.pos && a.id == b.id; };
+            bool same = tick.camPos == recorded.camPos && tick.yaw == recorded.yaw && tick.pitch == recorded.pitch
+                && std::equal(tick.edits.begin(), tick.edits.end(), recorded.edits.begin(), recorded.edits.end(), sameEdit);
+            if (!same && divergences++ == 0) firstDivergence = player_->ticks();
+            if (!fastReplay_) std::this_thread::sleep_until(wallStart + std::chrono::duration<double>(simTime_));
         }
-        renderer_->draw(vp, world_->blocks().size());
-        drawHUD(w, h);
-        glfwSwapBuffers(window_);
+
+        int w, h;
+        if (headless_) { w = offscreen_->width(); h = offscreen_->height(); }
+        else glfwGetFramebufferSize(window_.handle, &w, &h);
+        renderFrame(w, h);
+        glfwSwapBuffers(window_.handle);
+    }
+    if (headless_) Framebuffer::unbind();
+    if (autosaver_) autosave(); // final save; the writer drains it when the Application is destroyed
+
+    double wall = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    if (recorder_) std::printf("recorded %llu ticks, %llu bytes\n", (unsigned long long)recorder_->ticks(), (unsigned long long)recorder_->bytes());
+    if (client_) std::printf("network: received %llu bytes, sent %llu bytes\n", (unsigned long long)client_->bytesReceived(), (unsigned long long)client_->bytesSent());
+    if (player_) {
+        std::printf("replayed %llu ticks (%.2f s simulated) in %.2f s\n", (unsigned long long)player_->ticks(), simTime_, wall);
+        if (divergences) std::printf("DIVERGED on %llu ticks, first at tick %llu\n", (unsigned long long)divergences, (unsigned long long)firstDivergence);
+    }
+}
+
+void Application::renderFrame(int w, int h) {
+    scratchArena().reset(); // last frame's temporaries are dead by now
+    blockTextures_.update(); // uploads the block textures once the loader threads have read them
+    float aspect = (h>0) ? (float)w / (float)h : 1.0f;
+    glm::mat4 v = camera_->view();
+    glm::mat4 p = camera_->proj(aspect);
+    glm::mat4 vp = p * v;
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glViewport(0,0,w,h);
+    glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    world_->takeDirtyChunks(dirtyScratch_);
+    for (const ChunkCoord& coord : dirtyScratch_) { // local edits; streamed chunks arrive pre-meshed
+        meshChunk(coord, *world_->chunk(coord), meshScratch_);
+        renderer_->setChunkMesh(coord, meshScratch_);
+        scratchArena().reset(); // the mesher's temporaries die with each chunk, so a burst of edits doesn't pile them up
     }
+    renderer_->buildInstanceBuffer(instanceVBO_);
+    renderer_->draw(vp);
+    drawHUD(w, h);
+}
+
+bool Application::applyEdit(const EditCommand& edit) {
+    if (edit.place && (edit.id == BlockId::Air || !isReplaceable(world_->get(edit.pos)))) return false; // nothing held / occupied
+    if (client_) {
+        client_->sendEdit(BlockDelta{edit.pos, edit.place ? edit.id : BlockId::Air}); // the server applies and echoes it back
+    } else if (!edit.place) {
+        world_->remove(edit.pos);
+    } else {
+        world_->add(Block{edit.pos, edit.id});
+    }
+    if (ticker_) ticker_->wake(edit.pos);
+    tickEdits_.push_back(edit);
+    return true;
+}
+
+void Application::receiveChunks() {
+    client_->takeUpdates(updateScratch_);
+    for (const ChunkUpdate& update : updateScratch_) {
+        world_->replaceChunk(update.coord, update.chunk);
+        renderer_->setChunkMesh(update.coord, update.mesh);
+    }
+}
+
+void Application::setCursorCaptured(bool captured) {
+    cursorCaptured_ = captured;
+    if (!headless_) glfwSetInputMode(window_.handle, GLFW_CURSOR, captured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL); // Hide and disable mouse cursor when captured
+}
+
+int Application::runBenchmark(const ReplayScript& script) {
+    if (!headless_) throw std::runtime_error("runBenchmark requires a headless Application");
+    using Clock = std::chrono::steady_clock;
+    const int frames = script.frameCount();
+    std::vector<double> frameMs;
+    frameMs.reserve(frames);
+    renderer_->resetStats();
+    offscreen_->bind();
+    size_t nextEdit = 0;
+    const auto& edits = script.edits();
+    for (int frame = 0; frame < frames; ++frame) {
+        auto start = Clock::now();
+        tickEdits_.clear();
+        script.applyCamera(frame, *camera_);
+        while (nextEdit < edits.size() && edits[nextEdit].frame <= frame) applyEdit(edits[nextEdit++]);
+        simTime_ += 1.0 / 60.0; // each script frame advances the simulation by 1/60 s
+        stepSimulation();
+        renderFrame(offscreen_->width(), offscreen_->height());
+        glFinish(); // no swap to pace us, so wait for the GPU to make the timing honest
+        frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    Framebuffer::unbind();
+    if (frameMs.empty()) return 1;
+
+    const RenderStats& stats = renderer_->stats();
+    std::vector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&sorted](double q) { return sorted[std::min(sorted.size() - 1, size_t(q * double(sorted.size())))]; };
+    double total = 0.0;
+    for (double ms : frameMs) total += ms;
+    std::printf("frames=%d resolution=%dx%d culling=%s gl_renderer=\"%s\"\n", frames, offscreen_->width(), offscreen_->height(),
+                renderer_->gpuCulling() ? "gpu" : "cpu", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    std::printf("frame_ms mean=%.3f p50=%.3f p90=%.3f p99=%.3f max=%.3f\n",
+                total / frameMs.size(), pct(0.50), pct(0.90), pct(0.99), sorted.back());
+    std::printf("draw_calls_per_frame=%.1f triangles_per_frame=%.0f\n",
+                double(stats.drawCalls) / frames, double(stats.triangles) / frames);
+    int64_t totals[3] = {};
+    for (const StatSample& s : sampleStats()) {
+        if (s.unit != StatUnit::Count) totals[int(s.unit)] += s.value;
+    }
+    std::printf("memory cpu_bytes=%lld gpu_buffer_bytes=%lld gpu_texture_bytes=%lld\n",
+                (long long)totals[0], (long long)totals[1], (long long)totals[2]);
+    return 0;
 }
 
 void Application::drawHUD(int fbw, int fbh) {
@@ -188,40 +395,104 @@ void Application::drawHUD(int fbw, int fbh) {
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
 
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (showStats_) drawStatsOverlay(fbw, fbh);
 
     glBindVertexArray(0);
     glDisable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
 }
 
-void Application::processInput(float dt) {
+void Application::drawStatsOverlay(int fbw, int fbh) {
+    static const char* const kUnitLabels[] = {"cpu", "gpu buf", "gpu tex", "count"}; // by StatUnit
+    int64_t totals[3] = {};
+    char line[96];
+    statsLines_.clear();
+    std::snprintf(line, sizeof(line), "%-22s %-7s %10s %10s", "resource", "", "now", "peak");
+    statsLines_.emplace_back(line);
+    for (const StatSample& s : sampleStats()) {
+        if (s.unit != StatUnit::Count) totals[int(s.unit)] += s.value;
+        std::snprintf(line, sizeof(line), "%-22s %-7s %10s %10s", s.name, kUnitLabels[int(s.unit)],
+                      formatStatValue(s.unit, s.value).c_str(), formatStatValue(s.unit, s.highWater).c_str());
+        statsLines_.emplace_back(line);
+    }
+    for (int unit = 0; unit < 3; ++unit) {
+        std::snprintf(line, sizeof(line), "%-22s %-7s %10s", "total", kUnitLabels[unit], formatStatValue(StatUnit(unit), totals[unit]).c_str());
+        statsLines_.emplace_back(line);
+    }
+    statsText_->draw(statsLines_, fbw, fbh);
+}
+
+void Application::spawnPlayer() {
+    glm::vec3 centre = camera_->pos - glm::vec3(0.0f, PLAYER_EYE, 0.0f);
+    for (int i = 0; i < 256 && boxHitsSolid(*world_, centre - kPlayerHalfExtents, centre + kPlayerHalfExtents); ++i) centre.y += 1.0f;
+    playerSpawn_ = centre;
+    if (playerEntity_ == NO_ENTITY) playerEntity_ = entities_.spawn(centre, kPlayerHalfExtents, flying_ ? 0.0f : 1.0f);
+    entities_.setPosition(playerEntity_, centre);
+    entities_.setVelocity(playerEntity_, glm::vec3(0.0f));
+    camera_->pos = centre + glm::vec3(0.0f, PLAYER_EYE, 0.0f);
+    playerPlaced_ = !client_ || spawnColumnLoaded();
+}
+
+bool Application::spawnColumnLoaded() const {
+    const ChunkCoord column = chunkOf(glm::ivec3(glm::floor(camera_->pos + 0.5f)));
+    for (const auto& [coord, chunk] : world_->chunks()) {
+        if (coord.x == column.x && coord.z == column.z) return true;
+    }
+    return false;
+}
+
+void Application::stepPhysics(float dt) {
+    if (!playerPlaced_) { // connected: hold the player still until the ground under it has streamed in
+        if (!spawnColumnLoaded()) return;
+        spawnPlayer();
+    }
+    entities_.step(*world_, std::min(dt, 0.1f)); // a stalled frame shouldn't become one giant step
+    if (entities_.position(playerEntity_).y < float(BlockTicker::VOID_Y)) {
+        entities_.setPosition(playerEntity_, playerSpawn_);
+        entities_.setVelocity(playerEntity_, glm::vec3(0.0f));
+    }
+    camera_->pos = entities_.position(playerEntity_) + glm::vec3(0.0f, PLAYER_EYE, 0.0f);
+}
+
+void Application::processInput() {
     glm::vec3 f = camera_->front();
     f.y = 0.0f; // ignore vertical component for movement
     f = glm::normalize(f); // normalize to ensure consistent speed
     glm::vec3 r = camera_->right();
     r.y = 0.0f; // ignore vertical component for movement
     r = glm::normalize(r); // normalize to ensure consistent speed
-    glm::vec3 u = glm::vec3(0,1,0);
-    float v = camera_->moveSpeed * dt;
-    if (input_->isDown(Key::W)) camera_->pos += f * v;
-    if (input_->isDown(Key::S)) camera_->pos -= f * v;
-    if (input_->isDown(Key::D)) camera_->pos += r * v;
-    if (input_->isDown(Key::A)) camera_->pos -= r * v;
-    if (input_->isDown(Key::Space)) camera_->pos += u * v;
-    if (input_->isDown(Key::Shift)) camera_->pos -= u * v;
-    if (input_->isDown(Key::Escape)) glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+    // Input only sets the player's velocity; stepPhysics() moves it through the world
+    glm::vec3 walk(0.0f);
+    if (input_->isDown(Key::W)) walk += f;
+    if (input_->isDown(Key::S)) walk -= f;
+    if (input_->isDown(Key::D)) walk += r;
+    if (input_->isDown(Key::A)) walk -= r;
+    glm::vec3 vel = entities_.velocity(playerEntity_);
+    vel.x = walk.x * camera_->moveSpeed;
+    vel.z = walk.z * camera_->moveSpeed;
+    if (input_->wasPressed(Key::F)) {
+        flying_ = !flying_;
+        entities_.setGravityScale(playerEntity_, flying_ ? 0.0f : 1.0f);
+        vel.y = 0.0f;
+    }
+    if (flying_) vel.y = camera_->moveSpeed * (float(input_->isDown(Key::Space)) - float(input_->isDown(Key::Shift)));
+    else if (input_->isDown(Key::Space) && entities_.onGround(playerEntity_)) vel.y = PLAYER_JUMP_SPEED;
+    entities_.setVelocity(playerEntity_, vel);
+    if (input_->isDown(Key::Escape)) setCursorCaptured(false);
     if (input_->isDown(Mouse::Left)) {
-        glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        setCursorCaptured(true);
         firstMouse_ = true;
     }
-    if (input_->wasPressed(Key::N1)) heldBlockId_ = 0; // Tile
-    if (input_->wasPressed(Key::N2)) heldBlockId_ = 1; // Turf
-    if (input_->wasPressed(Key::N3)) heldBlockId_ = 2; // Cardboard
-    if (input_->wasPressed(Key::N0)) heldBlockId_ = -1; // No block held
+    static constexpr Key kSlotKeys[] = {Key::N1, Key::N2, Key::N3, Key::N4, Key::N5, Key::N6, Key::N7, Key::N8, Key::N9};
+    for (size_t i = 0; i < kHotbar.size() && i < std::size(kSlotKeys); ++i) {
+        if (input_->wasPressed(kSlotKeys[i])) heldBlock_ = kHotbar[i];
+    }
+    if (input_->wasPressed(Key::N0)) heldBlock_ = BlockId::Air; // No block held
+    if (input_->wasPressed(Key::F3)) showStats_ = !showStats_;
 }
 
 void Application::handleMouseLook() {
-    if (glfwGetInputMode(window_, GLFW_CURSOR) == GLFW_CURSOR_DISABLED) {
+    if (cursorCaptured_) {
         glm::vec2 mousePos = input_->mousePos();
         if (firstMouse_) {
             lastX_ = mousePos.x; lastY_ = mousePos.y; firstMouse_ = false;
@@ -236,24 +507,21 @@ void Application::handleMouseLook() {
 }
 
 void Application::handleBlockActions() {
-    static bool prevLeft = false, prevRight = false;
-    bool nowLeft = input_->isDown(Mouse::Left);
-    bool nowRight = input_->isDown(Mouse::Right);
-    double now = glfwGetTime();
+    // Only input state and simulated time feed in here, so a replayed session makes identical edits
+    double now = simTime_;
     constexpr double PLACE_COOLDOWN = 0.1;
     constexpr double BREAK_COOLDOWN = 0.1;
     constexpr float PLAYER_REACH = 10.0f;
-    if (nowLeft && !prevLeft) {
+    if (input_->wasPressed(Mouse::Left)) {
         BlockHitInfo hit = world_->raycast(camera_->pos, camera_->front(), PLAYER_REACH);
-        if (now - lastBreakTime_ > BREAK_COOLDOWN && hit.blockIndex != -1) {
-            world_->remove(world_->blocks()[hit.blockIndex].pos);
-            needUpload_ = true;
+        if (now - lastBreakTime_ > BREAK_COOLDOWN && hit.hit) {
+            applyEdit(EditCommand{0, false, hit.blockPos, BlockId::Tile});
             lastBreakTime_ = now;
         }
     }
-    if (nowRight && !prevRight) {
+    if (input_->wasPressed(Mouse::Right)) {
         BlockHitInfo hit = world_->raycast(camera_->pos, camera_->front(), PLAYER_REACH);
-        if (hit.blockIndex != -1 && hit.faceIndex != -1) {
+        if (hit.hit && hit.faceIndex != -1) {
             glm::ivec3 faceNormals[] = {
                 glm::ivec3(0, -1, 0),
                 glm::ivec3(1, 0, 0),
@@ -263,17 +531,13 @@ void Application::handleBlockActions() {
                 glm::ivec3(0, 0, -1)
             };
             glm::ivec3 spawnPos = hit.blockPos + faceNormals[hit.faceIndex];
-            bool exists = false;
-            for (const auto& b : world_->blocks()) {
-                if (b.pos == spawnPos) { exists = true; break; }
-            }
-            if (now - lastPlaceTime_ > PLACE_COOLDOWN && !exists) {
-                world_->add(Block{spawnPos, static_cast<BlockId>(heldBlockId_)});
-                needUpload_ = true;
+            // A solid block can't go where the player stands, or the next step would start inside it
+            const glm::vec3 toCell = glm::abs(glm::vec3(spawnPos) - entities_.position(playerEntity_));
+            const glm::vec3 reach = glm::vec3(0.5f) + entities_.halfExtents(playerEntity_);
+            if (isSolid(heldBlock_) && toCell.x < reach.x && toCell.y < reach.y && toCell.z < reach.z) return;
+            if (now - lastPlaceTime_ > PLACE_COOLDOWN && applyEdit(EditCommand{0, true, spawnPos, heldBlock_})) {
                 lastPlaceTime_ = now;
             }
         }
     }
-    prevLeft = nowLeft;
-    prevRight = nowRight;
 }
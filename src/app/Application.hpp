@@ -4,39 +4,90 @@
 #include "../world/World.hpp"
 #include "../camera.hpp"
 #include "../gfx/Texture.hpp"
+#include "../gfx/Framebuffer.hpp"
+#include "../gfx/TextOverlay.hpp"
+#include "ReplayScript.hpp"
+#include "Session.hpp"
+#include "../net/WorldClient.hpp"
+#include "../world/Autosave.hpp"
+#include "../world/BlockTicker.hpp"
+#include "../physics/Entities.hpp"
 #include <GLFW/glfw3.h>
 #include <memory>
 
 class Application {
 public:
-    Application(int width, int height, const char* title);
+    Application(int width, int height, const char* title, bool headless = false);
     ~Application();
     void run();
+    void setGpuCulling(bool enable); // on by default where GL 4.3 is available
+    void startRecording(const std::string& path); // call before run()
+    void startReplay(const std::string& path, bool fast); // call before run(); fast = no real-time pacing
+    void connect(const std::string& host, uint16_t port); // call before run(); the world then comes from a WorldServer
+    void enableAutosave(const std::string& dir); // call before run(); loads chunks saved there, then saves edits periodically
+    int runBenchmark(const ReplayScript& script); // headless only; prints the frame-time report
 private:
-    void processInput(float dt);
+    void renderFrame(int fbw, int fbh);
+    bool applyEdit(const EditCommand& edit); // false if it was a no-op
+    void setCursorCaptured(bool captured);
+    void receiveChunks();
+    void autosave();
+    void stepSimulation(); // runs the block ticks simTime_ has reached
+    void spawnPlayer(); // at the camera, lifted out of any blocks it starts in
+    bool spawnColumnLoaded() const; // a connected client has received a chunk in the player's column
+    void stepPhysics(float dt);
+    void processInput();
     void handleMouseLook();
     void handleBlockActions();
     void initHUD();
     void drawHUD(int fbw, int fbh);
+    void drawStatsOverlay(int fbw, int fbh);
 
-    GLFWwindow* window_ = nullptr;
+    struct Window { // owns the GL context, so it is declared first and destroyed after every GL object below
+        GLFWwindow* handle = nullptr;
+        ~Window();
+    };
+    Window window_;
+    bool headless_ = false;
+    std::unique_ptr<Framebuffer> offscreen_; // render target when headless
     std::unique_ptr<Input> input_;
     std::unique_ptr<Renderer> renderer_;
     std::unique_ptr<World> world_;
+    std::unique_ptr<BlockTicker> ticker_; // local worlds only; a server simulates its own
+    double blockTickTime_ = 0.0; // simTime_ of the last block tick
     std::unique_ptr<Camera> camera_;
+    Entities entities_;
+    EntityId playerEntity_ = NO_ENTITY; // the camera rides at its eye height
+    glm::vec3 playerSpawn_{}; // where falling into the void puts it back
+    bool playerPlaced_ = false; // false until spawnPlayer() has had terrain to lift the player out of
+    bool flying_ = false; // F: no gravity, Space/Shift move up and down
     InstanceVBO instanceVBO_;
-    Texture2D tex_[3];
+    TextureArray blockTextures_; // one layer per texture index
     Texture2D crosshairTex_;
-    bool needUpload_ = true;
     double lastPlaceTime_ = 0.0;
     double lastBreakTime_ = 0.0;
     double lastTime_ = 0.0;
+    double simTime_ = 0.0; // sum of tick dts; drives cooldowns so replays don't depend on wall time
     double lastX_ = 0.0, lastY_ = 0.0;
     bool firstMouse_ = true;
-    int heldBlockId_ = -1; // -1 for no block held, otherwise the ID of the held block
+    bool cursorCaptured_ = false;
+    std::vector<EditCommand> tickEdits_; // edits made during the current tick
+    std::unique_ptr<SessionRecorder> recorder_;
+    std::unique_ptr<SessionPlayer> player_;
+    bool fastReplay_ = false;
+    std::unique_ptr<WorldClient> client_;
+    std::vector<BlockInstance> meshScratch_;
+    std::vector<ChunkCoord> dirtyScratch_;
+    std::vector<ChunkUpdate> updateScratch_;
+    std::unique_ptr<Autosaver> autosaver_;
+    double lastAutosave_ = 0.0; // simTime_ of the last autosave
+    BlockId heldBlock_ = BlockId::Air; // Air for no block held
     std::unique_ptr<CubeMesh> cube_;
 
     std::unique_ptr<ShaderProgram> guiShader_;
     GLuint hudVao_ = 0, hudVbo_ = 0, hudEbo_ = 0;
     int crosshairPx_ = 100;
+    std::unique_ptr<TextOverlay> statsText_;
+    std::vector<std::string> statsLines_;
+    bool showStats_ = false; // F3
 };
@@ -0,0 +1,43 @@
+#include "PhysicsBench.hpp"
+#include "../physics/Entities.hpp"
+#include "../world/BlockTicker.hpp"
+#include "../world/TerrainGen.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+int runPhysicsBenchmark(int entityCount) {
+    using Clock = std::chrono::steady_clock;
+    World world(makeTerrain(32, 4, kDefaultTerrainSeed));
+
+    // Item-sized boxes scattered above the terrain (some beyond its edge, so they fall into the void)
+    std::mt19937 rng(kDefaultTerrainSeed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    Entities entities;
+    std::vector<EntityId> ids;
+    ids.reserve(entityCount);
+    for (int i = 0; i < entityCount; ++i) {
+        EntityId id = entities.spawn(glm::vec3(unit(rng) * 18.0f, 12.0f + unit(rng) * 8.0f, unit(rng) * 18.0f), glm::vec3(0.25f));
+        entities.setVelocity(id, glm::vec3(unit(rng) * 4.0f, unit(rng) * 6.0f, unit(rng) * 4.0f));
+        ids.push_back(id);
+    }
+
+    constexpr int STEPS = 200;
+    constexpr float DT = 1.0f / BlockTicker::TICK_RATE;
+    auto start = Clock::now();
+    for (int s = 0; s < STEPS; ++s) entities.step(world, DT);
+    double sec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    int resting = 0, fell = 0, embedded = 0;
+    for (EntityId id : ids) {
+        const glm::vec3 pos = entities.position(id), half = entities.halfExtents(id);
+        resting += entities.onGround(id);
+        fell += pos.y < float(BlockTicker::VOID_Y);
+        embedded += boxHitsSolid(world, pos - half, pos + half);
+    }
+    std::printf("entities=%d steps=%d resting=%d fell_out=%d\n", entityCount, STEPS, resting, fell);
+    std::printf("step_ms mean=%.3f entity_steps_per_sec=%.0f\n", sec * 1000.0 / STEPS, double(entityCount) * STEPS / sec);
+    if (embedded) std::printf("EMBEDDED: %d entities ended inside solid blocks\n", embedded);
+    return embedded ? 1 : 0;
+}
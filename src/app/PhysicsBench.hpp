@@ -0,0 +1,6 @@
+#pragma once
+
+// Headless Entities::step throughput on the default terrain; no GL needed. Drops entityCount boxes with random
+// velocities onto the terrain, prints ms per step and how many came to rest, and returns non-zero if any box
+// ends up inside a solid block.
+int runPhysicsBenchmark(int entityCount);
@@ -0,0 +1,74 @@
+#include "RayBench.hpp"
+#include "../world/TerrainGen.hpp"
+#include "../world/World.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Reference for raycastBatch: one ray at a time through World::get(), written independently of the packet kernel
+// (which World::raycast() shares) so the comparison below can catch a bug in it. Same traversal rules: blocks are
+// unit cubes centred on integers and the cell holding the origin is skipped.
+static BlockHitInfo scalarRaycast(const World& world, const Ray& ray) {
+    BlockHitInfo hit{false, glm::ivec3(0), -1, glm::ivec3(0), ray.maxDistance + 1.0f};
+    glm::ivec3 cell, step;
+    glm::vec3 tMax, tDelta;
+    for (int a = 0; a < 3; ++a) {
+        const float o = ray.origin[a] + 0.5f;
+        const float d = ray.direction[a];
+        const float c = std::floor(o);
+        cell[a] = int(c);
+        step[a] = (d > 0.0f) ? 1 : (d < 0.0f) ? -1 : 0;
+        tDelta[a] = (d != 0.0f) ? std::abs(1.0f / d) : INFINITY;
+        tMax[a] = (d > 0.0f) ? (c + 1.0f - o) / d : (d < 0.0f) ? (o - c) / -d : INFINITY;
+    }
+    for (;;) {
+        const int a = (tMax.x <= tMax.y && tMax.x <= tMax.z) ? 0 : (tMax.y <= tMax.z) ? 1 : 2;
+        const float t = tMax[a];
+        if (!(t <= ray.maxDistance)) return hit;
+        cell[a] += step[a];
+        tMax[a] += tDelta[a];
+        if (world.get(cell) == BlockId::Air) continue;
+        static constexpr int kEntryFace[3][2] = { {1, 3}, {2, 0}, {4, 5} }; // [axis][stepped +]
+        return BlockHitInfo{true, cell, kEntryFace[a][step[a] > 0], ray.origin + t * ray.direction, t};
+    }
+}
+
+int runRayBenchmark(int rayCount) {
+    using Clock = std::chrono::steady_clock;
+    World world(makeTerrain(32, 4, kDefaultTerrainSeed));
+
+    // NPC-style queries: origins scattered above the terrain, directions uniform, 8-16 blocks of reach
+    std::mt19937 rng(kDefaultTerrainSeed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Ray> rays;
+    rays.reserve(rayCount);
+    for (int i = 0; i < rayCount; ++i) {
+        glm::vec3 origin(unit(rng) * 20.0f, 6.0f + unit(rng) * 2.0f, unit(rng) * 20.0f);
+        glm::vec3 dir(unit(rng), unit(rng) - 0.5f, unit(rng));
+        rays.push_back(Ray{origin, glm::normalize(dir), 12.0f + unit(rng) * 4.0f});
+    }
+
+    std::vector<BlockHitInfo> scalar(rays.size()), batch(rays.size());
+    auto start = Clock::now();
+    for (size_t i = 0; i < rays.size(); ++i) scalar[i] = scalarRaycast(world, rays[i]);
+    double scalarSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    world.raycastBatch(rays, batch);
+    double batchSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    int mismatches = 0, hits = 0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        const BlockHitInfo& a = scalar[i];
+        const BlockHitInfo& b = batch[i];
+        hits += a.hit;
+        if (a.hit != b.hit || a.blockPos != b.blockPos || a.faceIndex != b.faceIndex || a.distance != b.distance) ++mismatches;
+    }
+    std::printf("rays=%d hits=%d\n", rayCount, hits);
+    std::printf("scalar rays_per_sec=%.0f\n", double(rayCount) / scalarSec);
+    std::printf("batch  rays_per_sec=%.0f (packet=%d)\n", double(rayCount) / batchSec, World::RAY_PACKET);
+    if (mismatches) std::printf("MISMATCH: %d batched results differ from the scalar reference\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Headless World::raycast vs World::raycastBatch throughput on the default terrain; no GL needed.
+// Prints rays/s for both paths and returns non-zero if any batched result differs from the scalar one.
+int runRayBenchmark(int rayCount);
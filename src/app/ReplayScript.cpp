@@ -0,0 +1,93 @@
+#include "ReplayScript.hpp"
+#include "../world/BlockRegistry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+ReplayScript ReplayScript::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open replay script: " + path);
+
+    ReplayScript script;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = line.substr(0, line.find('#'));
+        std::istringstream ss(line);
+        std::string cmd;
+        if (!(ss >> cmd)) continue; // blank or comment-only line
+
+        bool ok = false;
+        if (cmd == "cam") {
+            CameraKey k{};
+            ok = bool(ss >> k.frame >> k.pos.x >> k.pos.y >> k.pos.z >> k.yaw >> k.pitch);
+            if (ok) script.keys_.push_back(k);
+        } else if (cmd == "place") {
+            EditCommand e{0, true, glm::ivec3(0), BlockId::Tile};
+            int id = 0;
+            ok = bool(ss >> e.frame >> e.pos.x >> e.pos.y >> e.pos.z >> id);
+            if (ok && (id < 0 || id > 255 || !isRegistered(BlockId(id)))) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": unknown block id " + std::to_string(id));
+            }
+            e.id = static_cast<BlockId>(id);
+            if (ok) script.edits_.push_back(e);
+        } else if (cmd == "break") {
+            EditCommand e{0, false, glm::ivec3(0), BlockId::Tile};
+            ok = bool(ss >> e.frame >> e.pos.x >> e.pos.y >> e.pos.z);
+            if (ok) script.edits_.push_back(e);
+        } else if (cmd == "frames") {
+            ok = bool(ss >> script.frameCount_);
+        }
+        if (!ok) throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": malformed command '" + cmd + "'");
+    }
+    if (script.keys_.empty()) throw std::runtime_error(path + ": replay script has no camera keys");
+    script.finalize();
+    return script;
+}
+
+ReplayScript ReplayScript::orbit(int frames) {
+    if (frames <= 0) throw std::runtime_error("orbit needs a positive frame count");
+    ReplayScript script;
+    constexpr float RADIUS = 24.0f;
+    constexpr float HEIGHT = 12.0f;
+    constexpr int KEY_STEP = 10;
+    const float pitch = -glm::degrees(std::atan(HEIGHT / RADIUS)); // look down at the terrain centre
+    for (int f = 0; f <= frames; f += KEY_STEP) {
+        float theta = 2.0f * 3.14159265f * float(f) / float(frames);
+        glm::vec3 pos(RADIUS * std::cos(theta), HEIGHT, RADIUS * std::sin(theta));
+        script.keys_.push_back(CameraKey{f, pos, glm::degrees(theta) + 180.0f, pitch});
+    }
+    // Grow and tear down a small tower so the rebuild path is part of the measurement
+    for (int i = 0; i < 8; ++i) {
+        script.edits_.push_back(EditCommand{frames / 4 + i * 4, true, glm::ivec3(0, 4 + i, 0), BlockId::Cardboard});
+        script.edits_.push_back(EditCommand{frames / 2 + i * 4, false, glm::ivec3(0, 4 + i, 0), BlockId::Cardboard});
+    }
+    script.frameCount_ = frames;
+    script.finalize();
+    return script;
+}
+
+void ReplayScript::finalize() {
+    if (keys_.empty()) throw std::runtime_error("replay script has no camera keys");
+    auto byFrame = [](const auto& a, const auto& b) { return a.frame < b.frame; };
+    std::stable_sort(keys_.begin(), keys_.end(), byFrame);
+    std::stable_sort(edits_.begin(), edits_.end(), byFrame);
+    if (frameCount_ <= 0) {
+        frameCount_ = keys_.back().frame + 1;
+        if (!edits_.empty()) frameCount_ = std::max(frameCount_, edits_.back().frame + 1);
+    }
+}
+
+void ReplayScript::applyCamera(int frame, Camera& cam) const {
+    auto next = std::find_if(keys_.begin(), keys_.end(), [frame](const CameraKey& k) { return k.frame > frame; });
+    const CameraKey& a = (next == keys_.begin()) ? *next : *(next - 1);
+    const CameraKey& b = (next == keys_.end()) ? a : *next;
+    float t = (b.frame > a.frame) ? float(frame - a.frame) / float(b.frame - a.frame) : 0.0f;
+    t = glm::clamp(t, 0.0f, 1.0f);
+    cam.pos = glm::mix(a.pos, b.pos, t);
+    cam.yaw = glm::mix(a.yaw, b.yaw, t);
+    cam.pitch = glm::mix(a.pitch, b.pitch, t);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "../camera.hpp"
+#include "../world/Block.hpp"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+struct CameraKey { // Camera pose at a given frame; poses in between are linearly interpolated
+    int frame;
+    glm::vec3 pos;
+    float yaw;
+    float pitch;
+};
+
+struct EditCommand { // World edit applied at the start of a frame
+    int frame;
+    bool place; // false = break
+    glm::ivec3 pos;
+    BlockId id;
+};
+
+// Deterministic camera path + edit script driving the headless benchmark.
+// Text format, one command per line ('#' starts a comment):
+//   cam   <frame> <x> <y> <z> <yaw> <pitch>
+//   place <frame> <x> <y> <z> <blockId>
+//   break <frame> <x> <y> <z>
+//   frames <count>   (optional, defaults to last keyed frame + 1)
+class ReplayScript {
+public:
+    static ReplayScript load(const std::string& path); // throws std::runtime_error on malformed input
+    static ReplayScript orbit(int frames); // built-in path circling the default terrain; throws unless frames > 0
+
+    int frameCount() const { return frameCount_; }
+    void applyCamera(int frame, Camera& cam) const;
+    const std::vector<EditCommand>& edits() const { return edits_; } // sorted by frame
+
+private:
+    void finalize();
+
+    std::vector<CameraKey> keys_;
+    std::vector<EditCommand> edits_;
+    int frameCount_ = 0;
+};
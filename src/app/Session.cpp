@@ -0,0 +1,88 @@
+#include "Session.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+static constexpr char kMagic[4] = {'T', 'C', 'S', 'R'};
+static constexpr uint16_t kVersion = 1;
+
+enum TickFlags : uint8_t {
+    KeysChanged = 1 << 0,
+    ButtonsChanged = 1 << 1,
+};
+
+template <typename T> void SessionRecorder::put(const T& v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out_.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    bytes_ += sizeof(T);
+}
+
+SessionRecorder::SessionRecorder(const std::string& path, uint32_t terrainSeed, bool cursorCaptured) : out_(path, std::ios::binary) {
+    if (!out_) throw std::runtime_error("Cannot create session file: " + path);
+    put(kMagic);
+    put(kVersion);
+    put(terrainSeed);
+    put(uint8_t(cursorCaptured));
+}
+
+void SessionRecorder::write(const SessionTick& tick) {
+    uint8_t flags = 0;
+    if (ticks_ == 0 || tick.input.keys != prev_.keys) flags |= KeysChanged;
+    if (ticks_ == 0 || tick.input.mouseButtons != prev_.mouseButtons) flags |= ButtonsChanged;
+    put(flags);
+    put(tick.dt);
+    if (flags & KeysChanged) put(tick.input.keys);
+    if (flags & ButtonsChanged) put(tick.input.mouseButtons);
+    put(tick.input.mousePos);
+    put(tick.camPos);
+    put(tick.yaw);
+    put(tick.pitch);
+    put(uint16_t(tick.edits.size()));
+    for (const EditCommand& e : tick.edits) {
+        put(uint8_t(e.place));
+        put(e.pos);
+        put(uint8_t(e.id));
+    }
+    prev_ = tick.input;
+    ++ticks_;
+}
+
+template <typename T> bool SessionPlayer::get(T& v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return bool(in_.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+SessionPlayer::SessionPlayer(const std::string& path) : in_(path, std::ios::binary) {
+    if (!in_) throw std::runtime_error("Cannot open session file: " + path);
+    char magic[4];
+    uint16_t version = 0;
+    if (!get(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !get(version) || !get(seed_))
+        throw std::runtime_error("Not a session recording: " + path);
+    if (version != kVersion) throw std::runtime_error("Unsupported session version " + std::to_string(version));
+    uint8_t captured = 0;
+    if (!get(captured)) throw std::runtime_error("Not a session recording: " + path);
+    cursorCaptured_ = captured != 0;
+}
+
+bool SessionPlayer::next(SessionTick& tick) {
+    uint8_t flags = 0;
+    if (!get(flags)) return false;
+    tick.input = prev_;
+    uint16_t editCount = 0;
+    bool ok = get(tick.dt)
+        && (!(flags & KeysChanged) || get(tick.input.keys))
+        && (!(flags & ButtonsChanged) || get(tick.input.mouseButtons))
+        && get(tick.input.mousePos) && get(tick.camPos) && get(tick.yaw) && get(tick.pitch)
+        && get(editCount);
+    tick.edits.clear();
+    for (uint16_t i = 0; ok && i < editCount; ++i) {
+        uint8_t place = 0, id = 0;
+        glm::ivec3 pos;
+        ok = get(place) && get(pos) && get(id);
+        tick.edits.push_back(EditCommand{int(ticks_), place != 0, pos, static_cast<BlockId>(id)});
+    }
+    if (!ok) return false; // truncated tail, e.g. the recording process was killed
+    prev_ = tick.input;
+    ++ticks_;
+    return true;
+}
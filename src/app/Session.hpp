@@ -0,0 +1,55 @@
+#pragma once
+#include "../input/Input.hpp"
+#include "ReplayScript.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct SessionTick { // One iteration of Application::run
+    float dt = 0.0f;
+    InputFrame input;
+    glm::vec3 camPos{}; // pose after the tick was simulated, used to detect divergence on replay
+    float yaw = 0.0f, pitch = 0.0f;
+    std::vector<EditCommand> edits; // world edits the tick produced
+};
+
+// Binary session format (little endian):
+//   header: "TCSR" magic, u16 version, u32 terrain seed, u8 cursor captured at the start
+//   tick:   u8 flags, f32 dt, [keys bitset if flags&KeysChanged], [u8 buttons if flags&ButtonsChanged],
+//           vec2 mouse, vec3 pos, f32 yaw, f32 pitch, u16 edit count, edits (u8 place, ivec3 pos, u8 id)
+// Key and button state only change on a handful of ticks, so they are written as deltas against the previous tick.
+class SessionRecorder {
+public:
+    SessionRecorder(const std::string& path, uint32_t terrainSeed, bool cursorCaptured); // throws std::runtime_error
+    void write(const SessionTick& tick);
+    uint64_t ticks() const { return ticks_; }
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    template <typename T> void put(const T& v);
+
+    std::ofstream out_;
+    InputFrame prev_;
+    uint64_t ticks_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+class SessionPlayer {
+public:
+    explicit SessionPlayer(const std::string& path); // throws std::runtime_error
+    bool next(SessionTick& tick); // false at end of file
+    uint32_t terrainSeed() const { return seed_; }
+    bool cursorCaptured() const { return cursorCaptured_; } // mouse look only applies while captured
+    uint64_t ticks() const { return ticks_; }
+
+private:
+    template <typename T> bool get(T& v);
+
+    std::ifstream in_;
+    InputFrame prev_;
+    uint32_t seed_ = 0;
+    bool cursorCaptured_ = false;
+    uint64_t ticks_ = 0;
+};
@@ -0,0 +1,30 @@
+#include "ChunkMesher.hpp"
+#include "../world/BlockRegistry.hpp"
+#include "../mem/Arena.hpp"
+
+void meshChunk(const ChunkCoord& coord, const Chunk& chunk, std::vector<BlockInstance>& out) {
+    out.clear();
+    if (chunk.empty()) return;
+    out.reserve(chunk.nonAirCount());
+    // Opacity of every cell, looked up once: the hidden-block test below reads each cell up to seven times
+    bool* opaqueCells = scratchArena().alloc<bool>(CHUNK_VOLUME);
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) opaqueCells[Chunk::index(x, y, z)] = isOpaque(chunk.get(x, y, z));
+        }
+    }
+    auto opaque = [opaqueCells](int x, int y, int z) { return opaqueCells[Chunk::index(x, y, z)]; };
+    const glm::ivec3 base = chunkOrigin(coord);
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                BlockId id = chunk.get(x, y, z);
+                if (id == BlockId::Air) continue;
+                bool interior = x > 0 && y > 0 && z > 0 && x < CHUNK_SIZE - 1 && y < CHUNK_SIZE - 1 && z < CHUNK_SIZE - 1;
+                if (interior && opaque(x - 1, y, z) && opaque(x + 1, y, z) && opaque(x, y - 1, z) && opaque(x, y + 1, z)
+                    && opaque(x, y, z - 1) && opaque(x, y, z + 1)) continue; // fully hidden
+                out.push_back(BlockInstance{glm::vec3(base + glm::ivec3(x, y, z)), int(faceLayers(id))});
+            }
+        }
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "InstanceBuffer.hpp"
+#include "../world/Chunk.hpp"
+#include <vector>
+
+// Builds the instance list for one chunk. Touches no GL state, so it is safe to call from worker threads.
+// Blocks buried on all six sides by opaque blocks of the same chunk are skipped; chunk-border blocks are always kept
+// so a chunk never has to be remeshed because its neighbour changed.
+// Temporaries come from the calling thread's scratchArena(); the caller resets it between work items.
+void meshChunk(const ChunkCoord& coord, const Chunk& chunk, std::vector<BlockInstance>& out);
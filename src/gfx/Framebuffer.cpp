@@ -0,0 +1,42 @@
+#include "Framebuffer.hpp"
+#include "../mem/Stats.hpp"
+#include <stdexcept>
+
+static ResourceStat gTargetBytes("gfx.offscreen_target", StatUnit::GpuTextureBytes);
+static int64_t targetBytes(int width, int height) { return int64_t(width) * height * (4 + 4); } // RGBA8 + DEPTH24 (padded to 4 B)
+
+Framebuffer::Framebuffer(int width, int height) : width_(width), height_(height) {
+    glGenFramebuffers(1, &fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+
+    glGenRenderbuffers(1, &colorRbo_);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo_);
+
+    glGenRenderbuffers(1, &depthRbo_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRbo_);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) throw std::runtime_error("Offscreen framebuffer incomplete");
+    gTargetBytes.add(targetBytes(width, height));
+}
+
+Framebuffer::~Framebuffer() {
+    if (depthRbo_) glDeleteRenderbuffers(1, &depthRbo_);
+    if (colorRbo_) glDeleteRenderbuffers(1, &colorRbo_);
+    if (fbo_) glDeleteFramebuffers(1, &fbo_);
+    gTargetBytes.sub(targetBytes(width_, height_));
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+void Framebuffer::unbind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
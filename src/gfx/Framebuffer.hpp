@@ -0,0 +1,22 @@
+#pragma once
+#include "GL.hpp"
+
+class Framebuffer { // Offscreen render target (RGBA8 color + 24-bit depth) used by the headless mode
+public:
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    void bind() const;
+    static void unbind();
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+private:
+    GLuint fbo_ = 0;
+    GLuint colorRbo_ = 0;
+    GLuint depthRbo_ = 0;
+    int width_ = 0, height_ = 0;
+};
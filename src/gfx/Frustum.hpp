@@ -0,0 +1,26 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+
+struct Frustum { // Six inward-facing planes (xyz = normal, w = distance), extracted from a view-projection matrix
+    std::array<glm::vec4, 6> planes;
+
+    explicit Frustum(const glm::mat4& vp) { // Gribb/Hartmann: combine rows of the clip matrix
+        auto row = [&vp](int r) { return glm::vec4(vp[0][r], vp[1][r], vp[2][r], vp[3][r]); };
+        planes[0] = row(3) + row(0); // left
+        planes[1] = row(3) - row(0); // right
+        planes[2] = row(3) + row(1); // bottom
+        planes[3] = row(3) - row(1); // top
+        planes[4] = row(3) + row(2); // near
+        planes[5] = row(3) - row(2); // far
+    }
+
+    bool intersects(const glm::vec3& boxMin, const glm::vec3& boxMax) const {
+        for (const glm::vec4& p : planes) {
+            // Corner furthest along the plane normal; if even that is behind the plane the box is outside
+            glm::vec3 v(p.x >= 0 ? boxMax.x : boxMin.x, p.y >= 0 ? boxMax.y : boxMin.y, p.z >= 0 ? boxMax.z : boxMin.z);
+            if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,8 @@
+#pragma once // Single entry point for the OpenGL API so the rest of the tree stays platform agnostic
+#ifdef __APPLE__
+#include <OpenGL/gl3.h> // macOS stops at GL 4.1
+#else
+#define GL_GLEXT_PROTOTYPES // core entry points are exported directly by libGL on Linux
+#include <GL/glcorearb.h>
+#define TINYCRAFT_HAS_GL43 1 // compute shaders + multi-draw indirect can be compiled in; still checked at runtime
+#endif
@@ -1,16 +1,30 @@
 #include "InstanceBuffer.hpp"
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
+#include "../mem/Stats.hpp"
+
+static ResourceStat gInstanceBytes("gfx.instance_vbo", StatUnit::GpuBufferBytes);
 
 void InstanceVBO::init() {
     glGenBuffers(1, &vbo_);
 }
 InstanceVBO::~InstanceVBO() {
     glDeleteBuffers(1, &vbo_);
+    gInstanceBytes.track(reportedBytes_, 0);
 }
 void InstanceVBO::bind() const {
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
 }
 void InstanceVBO::update(const BlockInstance* blocks, size_t count) {
     bind();
-    glBufferData(GL_ARRAY_BUFFER, count * sizeof(BlockInstance), blocks, GL_STATIC_DRAW);
+    if (count > capacity_) { // grow geometrically; otherwise overwrite the existing storage in place
+        capacity_ = count + count / 2;
+        glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(BlockInstance), nullptr, GL_DYNAMIC_DRAW);
+        gInstanceBytes.track(reportedBytes_, int64_t(capacity_ * sizeof(BlockInstance)));
+    }
+    if (count > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(BlockInstance), blocks);
+}
+void InstanceVBO::write(size_t first, const BlockInstance* blocks, size_t count) {
+    if (count == 0) return;
+    bind();
+    glBufferSubData(GL_ARRAY_BUFFER, GLintptr(first * sizeof(BlockInstance)), GLsizeiptr(count * sizeof(BlockInstance)), blocks);
 }
\ No newline at end of file
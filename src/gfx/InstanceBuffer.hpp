@@ -1,11 +1,12 @@
 #pragma once // Header guard to prevent multiple inclusions
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
 #include <glm/glm.hpp>
 #include <cstddef> // offsetof
+#include <cstdint>
 
 struct BlockInstance { // Intended for GPU instancing
     glm::vec3 pos; // location 1
-    int texIndex; // location 3
+    int faceLayers; // location 3: texture array layer per BlockFace, 5 bits each (see BlockRegistry.hpp)
 };
 
 static_assert(sizeof(BlockInstance) == 16, "BlockInstance must stay tightly packed (vec3+int = 16 B)");
@@ -18,8 +19,12 @@ public:
     void bind() const;
     GLuint id() const { return vbo_; }
 
-    void update(const BlockInstance* blocks, size_t count);
+    void update(const BlockInstance* blocks, size_t count); // reuses the GL buffer storage while it is big enough
+    void write(size_t first, const BlockInstance* blocks, size_t count); // into existing storage; first + count <= capacity()
+    size_t capacity() const { return capacity_; } // in instances
 
 private:
     GLuint vbo_ = 0;
+    size_t capacity_ = 0;
+    int64_t reportedBytes_ = 0; // to the gfx.instance_vbo stat
 };
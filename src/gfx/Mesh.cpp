@@ -1,5 +1,8 @@
 #include "Mesh.hpp"
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
+#include "../mem/Stats.hpp"
+
+static ResourceStat gMeshBytes("gfx.cube_mesh", StatUnit::GpuBufferBytes);
 
 CubeMesh::CubeMesh() {
     float verts[] = {
@@ -65,6 +68,8 @@ CubeMesh::CubeMesh() {
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5*sizeof(float), (void*)0);
     indexCount_ = sizeof(idx)/sizeof(idx[0]);
+    bufferBytes_ = sizeof(verts) + sizeof(idx);
+    gMeshBytes.add(int64_t(bufferBytes_));
     glBindVertexArray(0);
 }
 
@@ -72,4 +77,5 @@ CubeMesh::~CubeMesh() {
     if (ebo_) glDeleteBuffers(1, &ebo_);
     if (vbo_) glDeleteBuffers(1, &vbo_);
     if (vao_) glDeleteVertexArrays(1, &vao_);
+    gMeshBytes.sub(int64_t(bufferBytes_));
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
+#include <cstddef>
 
 class CubeMesh {
 public:
@@ -15,4 +16,5 @@ private:
     GLuint vbo_ = 0; // Vertex Buffer Object
     GLuint ebo_ = 0; // Element Buffer Object
     GLsizei indexCount_ = 0; // Number of indices in the element buffer
+    size_t bufferBytes_ = 0; // vertex + index buffer sizes, for the gfx.cube_mesh stat
 };
\ No newline at end of file
@@ -1,31 +1,339 @@
 #include "Renderer.hpp"
+#include "Frustum.hpp"
 #include "../world/Block.hpp"
+#include "../mem/Arena.hpp"
+#include "../mem/Stats.hpp"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdint>
+
+static ResourceStat gChunkMeshes("gfx.chunk_meshes", StatUnit::Count);
+static ResourceStat gMeshStorage("gfx.mesh_storage", StatUnit::CpuBytes); // per-chunk meshes and spares
+static ResourceStat gCullBuffers("gfx.cull_buffers", StatUnit::GpuBufferBytes);
+
+#ifdef TINYCRAFT_HAS_GL43
+static const char* kCullCS = R"(
+#version 430 core
+layout(local_size_x = 64) in;
+struct ChunkRecord { vec4 boxMin; vec4 boxMax; uint first; uint count; uint pad0; uint pad1; };
+struct DrawCommand { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };
+layout(std430, binding = 0) readonly buffer Chunks { ChunkRecord chunks[]; };
+layout(std430, binding = 1) writeonly buffer Commands { DrawCommand commands[]; };
+layout(std430, binding = 2) buffer Counter { uint visibleInstances; };
+uniform vec4 uPlanes[6];
+uniform uint uChunkCount;
+uniform uint uIndexCount;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= uChunkCount) return;
+    ChunkRecord c = chunks[i];
+    bool visible = true;
+    for (int p = 0; p < 6 && visible; ++p) {
+        vec3 corner = mix(c.boxMin.xyz, c.boxMax.xyz, greaterThanEqual(uPlanes[p].xyz, vec3(0.0)));
+        visible = dot(uPlanes[p].xyz, corner) + uPlanes[p].w >= 0.0;
+    }
+    commands[i] = DrawCommand(uIndexCount, visible ? c.count : 0u, 0u, 0, c.first);
+    if (visible) atomicAdd(visibleInstances, c.count);
+}
+)";
+
+struct ChunkRecord { // std430 mirror of the compute shader's ChunkRecord
+    float boxMin[4];
+    float boxMax[4];
+    uint32_t first, count, pad0, pad1;
+};
+static_assert(sizeof(ChunkRecord) == 48, "ChunkRecord must match the std430 layout");
+
+struct DrawElementsIndirectCommand {
+    GLuint count, instanceCount, firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+#endif
 
 Renderer::Renderer(const char* vertSrc, const char* fragSrc, const CubeMesh& mesh) : shader_(vertSrc, fragSrc), mesh_(mesh) {
     uVP_ = glGetUniformLocation(shader_.id(), "uVP");
 }
 
-Renderer::~Renderer() {}
+Renderer::~Renderer() {
+    releaseGpuCulling();
+    gChunkMeshes.track(reportedMeshes_, 0);
+    gMeshStorage.track(reportedMeshBytes_, 0);
+}
 
-void Renderer::draw(const glm::mat4& vp, int instanceCount) {
+void Renderer::draw(const glm::mat4& vp) {
+    if (instanceCount_ == 0) return;
     shader_.use();
     glUniformMatrix4fv(uVP_, 1, GL_FALSE, glm::value_ptr(vp));
     glBindVertexArray(mesh_.getVAO());
-    glDrawElementsInstanced(GL_TRIANGLES, mesh_.getIndexCount(), GL_UNSIGNED_INT, 0, instanceCount);
+    if (gpuCulling_) drawGpuCulled(vp);
+    else drawCpuCulled(vp);
     glBindVertexArray(0);
 }
 
-void Renderer::buildInstanceBuffer(const std::vector<Block>& blocks, InstanceVBO& instanceVBO) {
-    instanceBuffer_.clear();
-    instanceBuffer_.reserve(blocks.size());
-    for (const Block& block : blocks) {
-        instanceBuffer_.push_back(BlockInstance{
-            glm::vec3(block.pos),
-            static_cast<int>(block.id)
-        });
+void Renderer::drawCpuCulled(const glm::mat4& vp) {
+    const Frustum frustum(vp);
+    const GLsizei trianglesPerCube = mesh_.getIndexCount() / 3;
+    // Visible chunks whose slots are full and adjacent in the VBO merge into a single draw
+    GLuint runFirst = 0, runCount = 0;
+    auto flush = [&] {
+        if (runCount == 0) return;
+        pointInstanceAttributes(runFirst);
+        glDrawElementsInstanced(GL_TRIANGLES, mesh_.getIndexCount(), GL_UNSIGNED_INT, 0, GLsizei(runCount));
+        stats_.drawCalls += 1;
+        stats_.triangles += (long long)trianglesPerCube * runCount;
+        runCount = 0;
+    };
+    for (const ChunkRange& r : ranges_) {
+        if (r.count == 0) continue;
+        if (!frustum.intersects(r.boxMin, r.boxMax)) { flush(); continue; }
+        if (runCount > 0 && r.first != runFirst + runCount) flush();
+        if (runCount == 0) runFirst = r.first;
+        runCount += r.count;
+    }
+    flush();
+    pointInstanceAttributes(0);
+}
+
+void Renderer::pointInstanceAttributes(GLuint firstInstance) {
+    const size_t base = size_t(firstInstance) * sizeof(BlockInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(BlockInstance), (void*)base);
+    glVertexAttribIPointer(3, 1, GL_INT, sizeof(BlockInstance), (void*)(base + offsetof(BlockInstance, faceLayers)));
+}
+
+#ifdef TINYCRAFT_HAS_GL43
+bool Renderer::setGpuCulling(bool enable) {
+    if (!enable) {
+        releaseGpuCulling();
+        return false;
+    }
+    if (gpuCulling_) return true;
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major < 4 || (major == 4 && minor < 3)) return false;
+
+    cullProgram_ = std::make_unique<ShaderProgram>(kCullCS);
+    uPlanes_ = glGetUniformLocation(cullProgram_->id(), "uPlanes");
+    uChunkCount_ = glGetUniformLocation(cullProgram_->id(), "uChunkCount");
+    uIndexCount_ = glGetUniformLocation(cullProgram_->id(), "uIndexCount");
+    glGenBuffers(1, &chunkSsbo_);
+    glGenBuffers(1, &indirectBuffer_);
+    glGenBuffers(COUNTER_RING, counterBuffers_);
+    const GLuint zero = 0;
+    for (GLuint buffer : counterBuffers_) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_READ);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    counterSlot_ = 0;
+    gCullBuffers.track(reportedCullBytes_, COUNTER_RING * sizeof(GLuint));
+    recordCapacity_ = 0;
+    chunkRecordsDirty_ = true;
+    gpuCulling_ = true;
+    return true;
+}
+
+static ChunkRecord toRecord(const glm::vec3& boxMin, const glm::vec3& boxMax, GLuint first, GLuint count) {
+    return ChunkRecord{{boxMin.x, boxMin.y, boxMin.z, 0.0f}, {boxMax.x, boxMax.y, boxMax.z, 0.0f}, first, count, 0, 0};
+}
+
+void Renderer::uploadChunkRecords() {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, chunkSsbo_);
+    if (GLsizeiptr(ranges_.size()) > recordCapacity_) { // both buffers are sized in chunks, so they grow together
+        recordCapacity_ = GLsizeiptr(ranges_.size()) * 2;
+        glBufferData(GL_SHADER_STORAGE_BUFFER, recordCapacity_ * GLsizeiptr(sizeof(ChunkRecord)), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, recordCapacity_ * GLsizeiptr(sizeof(DrawElementsIndirectCommand)), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        gCullBuffers.track(reportedCullBytes_, int64_t(COUNTER_RING * sizeof(GLuint)
+                                                       + recordCapacity_ * (sizeof(ChunkRecord) + sizeof(DrawElementsIndirectCommand))));
+        chunkRecordsDirty_ = true; // the new storage holds nothing yet
+    }
+    if (chunkRecordsDirty_) {
+        ChunkRecord* records = scratchArena().alloc<ChunkRecord>(ranges_.size()); // staging only lives until the upload
+        for (size_t i = 0; i < ranges_.size(); ++i) {
+            const ChunkRange& r = ranges_[i];
+            records[i] = toRecord(r.boxMin, r.boxMax, r.first, r.count);
+        }
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GLsizeiptr(ranges_.size() * sizeof(ChunkRecord)), records);
+    } else {
+        for (uint32_t i : dirtyRecords_) {
+            const ChunkRange& r = ranges_[i];
+            const ChunkRecord record = toRecord(r.boxMin, r.boxMax, r.first, r.count);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, GLintptr(i * sizeof(ChunkRecord)), sizeof(ChunkRecord), &record);
+        }
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    dirtyRecords_.clear();
+    chunkRecordsDirty_ = false;
+}
+
+void Renderer::drawGpuCulled(const glm::mat4& vp) {
+    if (ranges_.empty()) return;
+    if (chunkRecordsDirty_ || !dirtyRecords_.empty()) uploadChunkRecords();
+
+    // This frame's counter slot last held the count from COUNTER_RING frames ago. Its fence has normally signalled
+    // by now; the wait only blocks if the GPU has fallen that many frames behind, where the swap chain would block anyway.
+    const GLuint counter = counterBuffers_[counterSlot_];
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counter);
+    GLsync& fence = counterFences_[counterSlot_];
+    if (fence) {
+        GLuint visible = 0;
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000)); // 1 s, i.e. a lost device
+        glDeleteSync(fence);
+        fence = nullptr;
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &visible);
+        stats_.triangles += (long long)(mesh_.getIndexCount() / 3) * visible;
+    }
+    const GLuint zero = 0;
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    const Frustum frustum(vp);
+    const GLuint chunkCount = GLuint(ranges_.size());
+    cullProgram_->use();
+    glUniform4fv(uPlanes_, 6, glm::value_ptr(frustum.planes[0]));
+    glUniform1ui(uChunkCount_, chunkCount);
+    glUniform1ui(uIndexCount_, GLuint(mesh_.getIndexCount()));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunkSsbo_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, indirectBuffer_);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, counter);
+    glDispatchCompute((chunkCount + 63) / 64, 1, 1);
+    // Indirect commands feed the draw below; the counter is read back with glGetBufferSubData a few frames later
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    counterFences_[counterSlot_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    counterSlot_ = (counterSlot_ + 1) % COUNTER_RING;
+
+    shader_.use();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, GLsizei(chunkCount), 0); // baseInstance selects each chunk's slice
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    stats_.drawCalls += 1;
+}
+
+void Renderer::releaseGpuCulling() {
+    for (int i = 0; i < COUNTER_RING; ++i) {
+        if (counterFences_[i]) glDeleteSync(counterFences_[i]);
+        if (counterBuffers_[i]) glDeleteBuffers(1, &counterBuffers_[i]);
+        counterFences_[i] = nullptr;
+        counterBuffers_[i] = 0;
+    }
+    if (indirectBuffer_) glDeleteBuffers(1, &indirectBuffer_);
+    if (chunkSsbo_) glDeleteBuffers(1, &chunkSsbo_);
+    indirectBuffer_ = chunkSsbo_ = 0;
+    dirtyRecords_.clear();
+    gCullBuffers.track(reportedCullBytes_, 0);
+    cullProgram_.reset();
+    gpuCulling_ = false;
+}
+#else
+bool Renderer::setGpuCulling(bool) { return false; } // no GL 4.3 on this platform
+void Renderer::drawGpuCulled(const glm::mat4&) {}
+void Renderer::uploadChunkRecords() {}
+void Renderer::releaseGpuCulling() {}
+#endif
+
+void Renderer::setChunkMesh(const ChunkCoord& coord, const std::vector<BlockInstance>& instances) {
+    auto it = chunkMeshes_.find(coord);
+    if (instances.empty()) {
+        if (it == chunkMeshes_.end()) return;
+        ChunkMesh& mesh = it->second;
+        instanceCount_ -= mesh.instances.size();
+        wastedInstances_ += mesh.capacity;
+        ranges_[mesh.record].count = 0;
+        markRecordDirty(mesh.record);
+        freeRecords_.push_back(mesh.record);
+        mesh.instances.clear();
+        spareMeshes_.push_back(std::move(mesh.instances));
+        chunkMeshes_.erase(it);
+        return;
+    }
+    if (it == chunkMeshes_.end()) {
+        ChunkMesh mesh;
+        if (!spareMeshes_.empty()) {
+            mesh.instances = std::move(spareMeshes_.back());
+            spareMeshes_.pop_back();
+        }
+        if (!freeRecords_.empty()) {
+            mesh.record = freeRecords_.back();
+            freeRecords_.pop_back();
+        } else {
+            mesh.record = uint32_t(ranges_.size());
+            ranges_.emplace_back();
+        }
+        const glm::vec3 boxMin = glm::vec3(chunkOrigin(coord)) - glm::vec3(0.5f); // blocks are centred on integer positions
+        ranges_[mesh.record] = ChunkRange{boxMin, boxMin + glm::vec3(float(CHUNK_SIZE)), 0, 0};
+        it = chunkMeshes_.emplace(coord, std::move(mesh)).first;
     }
-    instanceVBO.update(instanceBuffer_.data(), instanceBuffer_.size());
+    ChunkMesh& mesh = it->second;
+    instanceCount_ += instances.size() - mesh.instances.size();
+    mesh.instances.assign(instances.begin(), instances.end()); // reuses the capacity a remeshed chunk already had
+    if (!mesh.dirty) dirtyMeshes_.push_back(coord);
+    mesh.dirty = true;
+}
+
+static size_t slotCapacity(size_t instances) { return instances + instances / 4; } // room to grow before a move
+
+void Renderer::buildInstanceBuffer(InstanceVBO& instanceVBO) {
+    if (dirtyMeshes_.empty()) return;
+    bool repack = false;
+    for (const ChunkCoord& coord : dirtyMeshes_) {
+        auto it = chunkMeshes_.find(coord);
+        if (it == chunkMeshes_.end()) continue; // dropped after it was remeshed
+        ChunkMesh& mesh = it->second;
+        ChunkRange& range = ranges_[mesh.record];
+        mesh.dirty = false;
+        if (mesh.instances.size() > mesh.capacity) { // outgrew its slot: give it a new one at the end
+            wastedInstances_ += mesh.capacity;
+            mesh.capacity = slotCapacity(mesh.instances.size());
+            range.first = GLuint(instanceEnd_);
+            instanceEnd_ += mesh.capacity;
+            repack = repack || instanceEnd_ > instanceVBO.capacity();
+        }
+        range.count = GLuint(mesh.instances.size());
+        markRecordDirty(mesh.record);
+        if (!repack) instanceVBO.write(range.first, mesh.instances.data(), mesh.instances.size());
+    }
+    dirtyMeshes_.clear();
+    if (repack || wastedInstances_ > instanceEnd_ / 2) repackInstances(instanceVBO);
+    reportMeshStats();
+}
+
+// Lays every chunk out again back to back, each with fresh headroom, and uploads the whole buffer at once. Only runs
+// when the VBO is full or mostly holes, so its cost is spread over many cheap per-chunk updates.
+void Renderer::repackInstances(InstanceVBO& instanceVBO) {
+    size_t end = 0;
+    for (auto& [coord, mesh] : chunkMeshes_) {
+        mesh.capacity = slotCapacity(mesh.instances.size());
+        end += mesh.capacity;
+    }
+    BlockInstance* staging = scratchArena().alloc<BlockInstance>(end); // staging only lives until the upload
+    size_t first = 0;
+    for (auto& [coord, mesh] : chunkMeshes_) {
+        ranges_[mesh.record].first = GLuint(first);
+        std::copy(mesh.instances.begin(), mesh.instances.end(), staging + first);
+        std::fill(staging + first + mesh.instances.size(), staging + first + mesh.capacity, BlockInstance{});
+        first += mesh.capacity;
+    }
+    instanceVBO.update(staging, end);
+    instanceEnd_ = end;
+    wastedInstances_ = 0;
+    chunkRecordsDirty_ = true;
+    dirtyRecords_.clear();
+}
+
+void Renderer::markRecordDirty(uint32_t record) {
+    if (gpuCulling_ && !chunkRecordsDirty_) dirtyRecords_.push_back(record); // otherwise the next upload sends them all
+}
+
+void Renderer::reportMeshStats() {
+    size_t bytes = 0;
+    for (const auto& [coord, mesh] : chunkMeshes_) bytes += mesh.instances.capacity() * sizeof(BlockInstance);
+    for (const std::vector<BlockInstance>& mesh : spareMeshes_) bytes += mesh.capacity() * sizeof(BlockInstance);
+    gMeshStorage.track(reportedMeshBytes_, int64_t(bytes));
+    gChunkMeshes.track(reportedMeshes_, int64_t(chunkMeshes_.size()));
 }
 
 void Renderer::setupAttributes(const CubeMesh& cube, const InstanceVBO& inst)
@@ -39,13 +347,14 @@ void Renderer::setupAttributes(const CubeMesh& cube, const InstanceVBO& inst)
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
 
+    instanceVbo_ = inst.id();
     glBindBuffer(GL_ARRAY_BUFFER, inst.id());
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(BlockInstance), (void*)0);
     glVertexAttribDivisor(1, 1);
 
     glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 1, GL_INT, sizeof(BlockInstance), (void*)offsetof(BlockInstance, texIndex));
+    glVertexAttribIPointer(3, 1, GL_INT, sizeof(BlockInstance), (void*)offsetof(BlockInstance, faceLayers));
     glVertexAttribDivisor(3, 1);
 
     glBindVertexArray(0);
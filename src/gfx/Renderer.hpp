@@ -3,23 +3,91 @@
 #include "Mesh.hpp"
 #include "InstanceBuffer.hpp"
 #include "../world/Block.hpp"
+#include "../world/Chunk.hpp"
+#include "../mem/Pool.hpp"
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
+struct RenderStats { // Accumulated since the last resetStats()
+    long long drawCalls = 0;
+    long long triangles = 0; // with GPU culling, counted as readbacks arrive, a couple of frames late
+};
+
 class Renderer {
 public:
     Renderer(const char* vertSrc, const char* fragSrc, const CubeMesh& mesh);
     ~Renderer();
 
-    void draw(const glm::mat4& vp, int instanceCount);
+    void draw(const glm::mat4& vp);
     ShaderProgram& shader() { return shader_; }
+    const RenderStats& stats() const { return stats_; }
+    void resetStats() { stats_ = RenderStats{}; }
 
-    void buildInstanceBuffer(const std::vector<Block>& blocks, InstanceVBO& instanceVBO);
+    void setChunkMesh(const ChunkCoord& coord, const std::vector<BlockInstance>& instances); // copied into recycled storage; empty list drops the chunk
+    void buildInstanceBuffer(InstanceVBO& instanceVBO); // uploads the chunks whose mesh changed since the last call
     void setupAttributes(const CubeMesh& cube, const InstanceVBO& inst);
 
+    // GPU-driven path (GL 4.3+): a compute shader frustum-culls every chunk and writes one indirect command per
+    // chunk, so draw() costs one dispatch + one glMultiDrawElementsIndirect regardless of how many chunks exist.
+    // Without it chunks are culled on the CPU and visible runs are drawn with glDrawElementsInstanced (GL 3.3).
+    bool setGpuCulling(bool enable); // returns whether the GPU path is now active
+    bool gpuCulling() const { return gpuCulling_; }
+
 private:
+    struct ChunkRange { // a chunk's slice of the instance VBO and its bounds; count 0 marks a free record
+        glm::vec3 boxMin, boxMax;
+        GLuint first, count;
+    };
+    // Each chunk keeps its slot in the instance VBO (room for its mesh plus some growth) and its index into ranges_
+    // (= its ChunkRecord and indirect command) until it is dropped, so a remesh rewrites only that chunk's slice
+    struct ChunkMesh {
+        std::vector<BlockInstance> instances;
+        uint32_t record = 0;
+        size_t capacity = 0; // instances the slot has room for; 0 until the first upload places it
+        bool dirty = false; // queued in dirtyMeshes_
+    };
+
+    void drawCpuCulled(const glm::mat4& vp);
+    void drawGpuCulled(const glm::mat4& vp);
+    void pointInstanceAttributes(GLuint firstInstance); // GL 3.3 has no baseInstance, so offset the attributes
+    void repackInstances(InstanceVBO& instanceVBO);
+    void markRecordDirty(uint32_t record);
+    void uploadChunkRecords();
+    void releaseGpuCulling();
+    void reportMeshStats();
+
     ShaderProgram shader_;
     const CubeMesh& mesh_;
     GLint uVP_;
-    std::vector<BlockInstance> instanceBuffer_;
+    using MeshMap = std::unordered_map<ChunkCoord, ChunkMesh, ChunkCoordHash, std::equal_to<ChunkCoord>,
+                                       PoolAllocator<std::pair<const ChunkCoord, ChunkMesh>>>;
+    MeshMap chunkMeshes_;
+    std::vector<std::vector<BlockInstance>> spareMeshes_; // storage of dropped chunks, reused by the next new one
+    std::vector<ChunkCoord> dirtyMeshes_; // chunks to upload at the next buildInstanceBuffer()
+    size_t instanceCount_ = 0; // instances across all chunk meshes
+    size_t instanceEnd_ = 0; // end of the last slot in the VBO
+    size_t wastedInstances_ = 0; // slots left behind by dropped or moved chunks; reclaimed by repackInstances()
+    std::vector<ChunkRange> ranges_; // indexed by ChunkMesh::record
+    std::vector<uint32_t> freeRecords_;
+    GLuint instanceVbo_ = 0;
+    RenderStats stats_;
+
+    bool gpuCulling_ = false;
+    bool chunkRecordsDirty_ = true; // re-upload every record; otherwise only dirtyRecords_
+    std::vector<uint32_t> dirtyRecords_;
+    std::unique_ptr<ShaderProgram> cullProgram_;
+    GLint uPlanes_ = -1, uChunkCount_ = -1, uIndexCount_ = -1;
+    GLuint chunkSsbo_ = 0, indirectBuffer_ = 0;
+    // Visible-instance counters, one per frame in flight: a frame reads back the counter written COUNTER_RING - 1
+    // frames ago once its fence has signalled, so the readback doesn't wait on the compute pass just dispatched
+    static constexpr int COUNTER_RING = 3;
+    GLuint counterBuffers_[COUNTER_RING] = {};
+    GLsync counterFences_[COUNTER_RING] = {};
+    int counterSlot_ = 0;
+    GLsizeiptr recordCapacity_ = 0; // chunks the record and indirect buffers have room for
+
+    int64_t reportedMeshes_ = 0, reportedMeshBytes_ = 0, reportedCullBytes_ = 0; // what our stats currently include
 };
@@ -1,7 +1,7 @@
 #include "Shader.hpp"
 #include <string>
 #include <stdexcept>
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
 
 
 ShaderProgram::ShaderProgram(const char* vertSrc, const char* fragSrc) {
@@ -12,6 +12,14 @@ ShaderProgram::ShaderProgram(const char* vertSrc, const char* fragSrc) {
     glDeleteShader(fs);
 }
 
+#ifdef TINYCRAFT_HAS_GL43
+ShaderProgram::ShaderProgram(const char* computeSrc) {
+    GLuint cs = compile(GL_COMPUTE_SHADER, computeSrc);
+    program_ = link(cs);
+    glDeleteShader(cs);
+}
+#endif
+
 ShaderProgram::~ShaderProgram() { // destructor to clean up resources
     if (program_) glDeleteProgram(program_);
 }
@@ -58,6 +66,17 @@ GLuint ShaderProgram::link(GLuint vs, GLuint fs) {
     glAttachShader(prog, vs);
     glAttachShader(prog, fs);
     glLinkProgram(prog);
+    return checkLinked(prog);
+}
+
+GLuint ShaderProgram::link(GLuint cs) {
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, cs);
+    glLinkProgram(prog);
+    return checkLinked(prog);
+}
+
+GLuint ShaderProgram::checkLinked(GLuint prog) {
     GLint ok = 0;
     glGetProgramiv(prog, GL_LINK_STATUS, &ok);
     if (!ok) {
@@ -1,9 +1,12 @@
 #pragma once // Header guard to prevent multiple inclusions
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
 
 class ShaderProgram {
 public:
     ShaderProgram(const char* vertSrc, const char* fragSrc);
+#ifdef TINYCRAFT_HAS_GL43
+    explicit ShaderProgram(const char* computeSrc); // compute program, needs a GL 4.3 context
+#endif
     ~ShaderProgram();
 
     ShaderProgram(const ShaderProgram&) = delete; // disable copy constructor. otherwise c++ compiler will generate a default copy constructor
@@ -18,4 +21,6 @@ private:
     GLuint program_ = 0; // OpenGL program ID
     static GLuint compile(GLenum type, const char* src);
     static GLuint link(GLuint vs, GLuint fs);
+    static GLuint link(GLuint cs);
+    static GLuint checkLinked(GLuint prog);
 };
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "TextOverlay.hpp"
+#include "../mem/Stats.hpp"
+#include <algorithm>
+
+static ResourceStat gOverlayBuffers("gfx.text_overlay", StatUnit::GpuBufferBytes);
+
+static constexpr int GLYPH_W = 5, GLYPH_H = 7;
+static constexpr int CELL_W = GLYPH_W + 1, CELL_H = GLYPH_H + 1; // one texel of spacing right and below
+static constexpr int ATLAS_COLS = 16, ATLAS_ROWS = 5; // 64 glyphs, then the panel cell
+static constexpr int PANEL_CELL = 64;
+
+// Rows top to bottom, bit 4 = leftmost column
+static const uint8_t kGlyphs[64][GLYPH_H] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // !
+    {0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a}, // #
+    {0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04}, // $
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+    {0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d}, // &
+    {0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // )
+    {0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00}, // *
+    {0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08}, // ,
+    {0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c}, // .
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // /
+    {0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e}, // 0
+    {0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e}, // 1
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f}, // 2
+    {0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e}, // 3
+    {0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02}, // 4
+    {0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e}, // 5
+    {0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e}, // 6
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+    {0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e}, // 8
+    {0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c}, // 9
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00}, // :
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08}, // ;
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // <
+    {0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00}, // =
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // >
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // ?
+    {0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e}, // @
+    {0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11}, // A
+    {0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e}, // B
+    {0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e}, // C
+    {0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c}, // D
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f}, // E
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10}, // F
+    {0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f}, // G
+    {0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11}, // H
+    {0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f}, // L
+    {0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+    {0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e}, // O
+    {0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10}, // P
+    {0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d}, // Q
+    {0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11}, // R
+    {0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e}, // S
+    {0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a}, // W
+    {0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11}, // X
+    {0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x04}, // Y
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f}, // Z
+    {0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e}, // [
+    {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // backslash
+    {0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e}, // ]
+    {0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f}, // _
+};
+
+TextOverlay::TextOverlay() {
+    constexpr int W = ATLAS_COLS * CELL_W, H = ATLAS_ROWS * CELL_H;
+    std::vector<uint8_t> pixels(size_t(W) * H * 4, 0); // row 0 = top, so V grows downwards
+    for (int g = 0; g < 64; ++g) {
+        for (int y = 0; y < GLYPH_H; ++y) {
+            for (int x = 0; x < GLYPH_W; ++x) {
+                if (!(kGlyphs[g][y] & (0x10 >> x))) continue;
+                uint8_t* p = &pixels[(size_t((g / ATLAS_COLS) * CELL_H + y) * W + (g % ATLAS_COLS) * CELL_W + x) * 4];
+                p[0] = p[1] = p[2] = p[3] = 255;
+            }
+        }
+    }
+    for (int y = 0; y < CELL_H; ++y) {
+        for (int x = 0; x < CELL_W; ++x) {
+            uint8_t* p = &pixels[(size_t((PANEL_CELL / ATLAS_COLS) * CELL_H + y) * W + (PANEL_CELL % ATLAS_COLS) * CELL_W + x) * 4];
+            p[3] = 170; // translucent black
+        }
+    }
+    glGenTextures(1, &atlas_);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+    glGenBuffers(1, &vbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glEnableVertexAttribArray(0); // aPos
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1); // aUV
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glBindVertexArray(0);
+}
+
+TextOverlay::~TextOverlay() {
+    if (vbo_) glDeleteBuffers(1, &vbo_);
+    if (vao_) glDeleteVertexArrays(1, &vao_);
+    if (atlas_) glDeleteTextures(1, &atlas_);
+    gOverlayBuffers.track(reportedBytes_, 0);
+}
+
+void TextOverlay::draw(const std::vector<std::string>& lines, int fbw, int fbh, int scale) {
+    if (lines.empty() || fbw <= 0 || fbh <= 0) return;
+    const float atlasW = float(ATLAS_COLS * CELL_W), atlasH = float(ATLAS_ROWS * CELL_H);
+    verts_.clear();
+    auto quad = [&](float x0, float y0, float x1, float y1, int cell, float cellW, float cellH) { // pixels, y down
+        const float u0 = float((cell % ATLAS_COLS) * CELL_W) / atlasW, v0 = float((cell / ATLAS_COLS) * CELL_H) / atlasH;
+        const float u1 = u0 + cellW / atlasW, v1 = v0 + cellH / atlasH;
+        const float nx0 = x0 / float(fbw) * 2.0f - 1.0f, nx1 = x1 / float(fbw) * 2.0f - 1.0f;
+        const float ny0 = 1.0f - y0 / float(fbh) * 2.0f, ny1 = 1.0f - y1 / float(fbh) * 2.0f;
+        const float v[6][4] = {{nx0, ny0, u0, v0}, {nx0, ny1, u0, v1}, {nx1, ny1, u1, v1},
+                               {nx1, ny1, u1, v1}, {nx1, ny0, u1, v0}, {nx0, ny0, u0, v0}};
+        verts_.insert(verts_.end(), &v[0][0], &v[0][0] + 24);
+    };
+
+    const float margin = 8.0f, pad = 4.0f;
+    const float cw = float(CELL_W * scale), ch = float(CELL_H * scale);
+    size_t columns = 0;
+    for (const std::string& line : lines) columns = std::max(columns, line.size());
+    quad(margin - pad, margin - pad, margin + cw * float(columns) + pad, margin + ch * float(lines.size()) + pad, PANEL_CELL, 1.0f, 1.0f);
+    for (size_t row = 0; row < lines.size(); ++row) {
+        for (size_t col = 0; col < lines[row].size(); ++col) {
+            int c = static_cast<unsigned char>(lines[row][col]);
+            if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+            if (c <= ' ' || c > '_') continue; // blank, or no glyph for it
+            const float x = margin + cw * float(col), y = margin + ch * float(row);
+            quad(x, y, x + cw, y + ch, c - ' ', float(CELL_W), float(CELL_H));
+        }
+    }
+
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    if (verts_.size() > capacity_) {
+        capacity_ = verts_.size() + verts_.size() / 2;
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity_ * sizeof(float)), nullptr, GL_DYNAMIC_DRAW);
+        gOverlayBuffers.track(reportedBytes_, int64_t(capacity_ * sizeof(float)));
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(verts_.size() * sizeof(float)), verts_.data());
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(verts_.size() / 4));
+    glBindVertexArray(0);
+}
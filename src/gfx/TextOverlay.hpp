@@ -0,0 +1,24 @@
+#pragma once
+#include "GL.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Monospaced debug text in the top-left corner on a translucent panel, using a built-in 5x7 bitmap font
+// (ASCII 32..95; lower case is drawn as upper case). Draws with whatever program is bound, which must take a
+// vec2 NDC position at location 0 and a vec2 UV at location 1 and sample unit 10, like the HUD shader.
+class TextOverlay {
+public:
+    TextOverlay(); // needs a current GL context
+    ~TextOverlay();
+    TextOverlay(const TextOverlay&) = delete;
+    TextOverlay& operator=(const TextOverlay&) = delete;
+
+    void draw(const std::vector<std::string>& lines, int fbw, int fbh, int scale = 2);
+
+private:
+    GLuint vao_ = 0, vbo_ = 0, atlas_ = 0;
+    size_t capacity_ = 0; // floats the VBO has room for
+    std::vector<float> verts_; // rebuilt every draw, keeps its capacity
+    int64_t reportedBytes_ = 0;
+};
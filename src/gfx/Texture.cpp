@@ -1,17 +1,26 @@
 #include "../../external/stb_image.h"
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include "Texture.hpp"
+#include "../mem/Stats.hpp"
+
+static ResourceStat gTextureBytes("gfx.textures_2d", StatUnit::GpuTextureBytes);
+static ResourceStat gBlockTextureBytes("gfx.block_textures", StatUnit::GpuTextureBytes);
+static ResourceStat gStagingBytes("gfx.texture_staging", StatUnit::GpuBufferBytes);
 
 bool Texture2D::load(const std::string& path) {
     stbi_set_flip_vertically_on_load(true);
     unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4); // RGBA
     if (!data) return false;
 
-    glGenTextures(1, &texID);
+    if (!texID) glGenTextures(1, &texID);
     glBindTexture(GL_TEXTURE_2D, texID);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
+    gTextureBytes.track(reportedBytes_, int64_t(width) * height * 4 * 4 / 3); // the mip chain adds about a third
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     
@@ -21,4 +30,107 @@ bool Texture2D::load(const std::string& path) {
 
     stbi_image_free(data);
     return true;
-}
\ No newline at end of file
+}
+
+Texture2D::~Texture2D() {
+    if (texID) glDeleteTextures(1, &texID);
+    gTextureBytes.track(reportedBytes_, 0);
+}
+
+TextureArray::~TextureArray() {
+    for (std::thread& t : workers_) t.join();
+    if (pbo_) { // a load that never finished; deleting also unmaps it
+        glDeleteBuffers(1, &pbo_);
+        gStagingBytes.sub(int64_t(pack_.totalBytes()));
+    }
+    if (texID) glDeleteTextures(1, &texID);
+    gBlockTextureBytes.track(reportedBytes_, 0);
+}
+
+bool TextureArray::beginLoad(const std::vector<std::string>& sources, const std::string& packPath) {
+    packPath_ = packPath;
+    if (!readTexturePackInfo(packPath, sources, pack_)) { // first run, or a source image changed since the bake
+        if (!bakeTexturePack(sources, packPath) || !readTexturePackInfo(packPath, sources, pack_)) return false;
+    }
+    width = int(pack_.width);
+    height = int(pack_.height);
+    layers = int(pack_.layers);
+
+    // Storage for every level now, pixels later: nothing here waits on the disk
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+    for (uint32_t level = 0; level < pack_.mipLevels; ++level) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, GLint(level), GL_RGBA8, std::max(1, width >> level), std::max(1, height >> level),
+                     layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    gBlockTextureBytes.track(reportedBytes_, int64_t(pack_.totalBytes()));
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, GLint(pack_.mipLevels - 1));
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    const size_t total = pack_.totalBytes();
+    glGenBuffers(1, &pbo_);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(total), nullptr, GL_STREAM_DRAW);
+    auto* mapped = static_cast<char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(total),
+                                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // left bound, it would redirect every other texture upload
+    if (!mapped) {
+        glDeleteBuffers(1, &pbo_);
+        pbo_ = 0;
+        return false;
+    }
+    gStagingBytes.add(int64_t(total));
+
+    // Each worker reads its own slice of the pack straight into the mapped buffer
+    constexpr size_t BYTES_PER_WORKER = 256 * 1024; // below this, thread start-up costs more than the read
+    const size_t workers = std::clamp<size_t>(total / BYTES_PER_WORKER, 1, std::max(1u, std::thread::hardware_concurrency()));
+    pending_ = int(workers);
+    for (size_t w = 0; w < workers; ++w) {
+        workers_.emplace_back([this, mapped, total, w, workers] {
+            const size_t begin = total * w / workers, end = total * (w + 1) / workers;
+            std::ifstream in(packPath_, std::ios::binary);
+            if (!in.seekg(std::streamoff(pack_.dataOffset + begin)) || !in.read(mapped + begin, std::streamsize(end - begin))) {
+                readFailed_ = true;
+            }
+            --pending_;
+        });
+    }
+    return true;
+}
+
+bool TextureArray::update() {
+    if (ready_) return true;
+    if (!pbo_ || pending_ > 0) return false;
+    for (std::thread& t : workers_) t.join();
+    workers_.clear();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+    const bool intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE && !readFailed_; // unmap fails if the driver lost the contents
+    if (intact) {
+        // Sourced from the buffer, so these return at once and the driver copies in the background
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+        for (uint32_t level = 0; level < pack_.mipLevels; ++level) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, GLint(level), 0, 0, 0, std::max(1, width >> level), std::max(1, height >> level),
+                            layers, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(pack_.levelOffset(level)));
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &pbo_); // GL keeps the storage until the pending copies have read it
+    pbo_ = 0;
+    gStagingBytes.sub(int64_t(pack_.totalBytes()));
+    if (!intact) {
+        std::fprintf(stderr, "failed to load texture pack %s\n", packPath_.c_str());
+        return false;
+    }
+    ready_ = true;
+    return true;
+}
+
+void TextureArray::finishLoad() {
+    for (std::thread& t : workers_) t.join();
+    workers_.clear();
+    update();
+}
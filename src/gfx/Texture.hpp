@@ -1,12 +1,55 @@
 #pragma once
 #include "../../external/stb_image.h"
-#include <OpenGL/gl3.h>
+#include "GL.hpp"
+#include "TexturePack.hpp"
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <thread>
+#include <vector>
 
 class Texture2D {
 public:
-    GLuint texID;
-    int width, height, channels;
+    GLuint texID = 0;
+    int width = 0, height = 0, channels = 0;
 
-    bool load(const std::string& path);
-};
\ No newline at end of file
+    Texture2D() = default;
+    Texture2D(const Texture2D&) = delete;
+    Texture2D& operator=(const Texture2D&) = delete;
+    ~Texture2D();
+
+    bool load(const std::string& path); // loading again replaces the image in the same texture object
+
+private:
+    int64_t reportedBytes_ = 0; // to the gfx.textures_2d stat
+};
+
+// Block textures, loaded from a baked TexturePack (rebaked first if missing or stale). beginLoad() only allocates
+// the texture and a mapped pixel buffer; worker threads copy the pack's pixels into it while the main thread keeps
+// rendering, and update() issues the uploads from the buffer once they are done. Until then the texture is incomplete
+// and samples as black.
+class TextureArray {
+public:
+    GLuint texID = 0;
+    int width = 0, height = 0, layers = 0;
+
+    TextureArray() = default;
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+    ~TextureArray();
+
+    bool beginLoad(const std::vector<std::string>& sources, const std::string& packPath);
+    bool update(); // call once per frame; true once the texture is complete
+    void finishLoad(); // blocks until the texture is complete (or the load failed)
+    bool ready() const { return ready_; }
+
+private:
+    TexturePackInfo pack_;
+    std::string packPath_;
+    GLuint pbo_ = 0;
+    std::vector<std::thread> workers_;
+    std::atomic<int> pending_{0}; // workers still copying
+    std::atomic<bool> readFailed_{false};
+    bool ready_ = false;
+    int64_t reportedBytes_ = 0; // to the gfx.block_textures stat
+};
@@ -0,0 +1,163 @@
+#include "TexturePack.hpp"
+#include "../../external/stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static constexpr char kMagic[4] = {'T', 'C', 'T', 'P'};
+static constexpr uint32_t kVersion = 1;
+
+struct SourceStamp { uint64_t size; int64_t mtime; };
+
+static bool stampOf(const std::string& path, SourceStamp& out) {
+    std::error_code ec;
+    out.size = fs::file_size(path, ec);
+    if (ec) return false;
+    out.mtime = int64_t(fs::last_write_time(path, ec).time_since_epoch().count());
+    return !ec;
+}
+
+size_t TexturePackInfo::levelBytes(uint32_t level) const {
+    return size_t(std::max(1u, width >> level)) * std::max(1u, height >> level) * 4 * layers;
+}
+
+size_t TexturePackInfo::levelOffset(uint32_t level) const {
+    size_t offset = 0;
+    for (uint32_t l = 0; l < level; ++l) offset += levelBytes(l);
+    return offset;
+}
+
+// Box filter: each texel of the smaller level averages the 2x2 (or 2x1 once an axis reaches 1) it covers
+static void downsample(const uint8_t* src, int sw, int sh, uint8_t* dst, int dw, int dh) {
+    for (int y = 0; y < dh; ++y) {
+        for (int x = 0; x < dw; ++x) {
+            const int x0 = std::min(2 * x, sw - 1), x1 = std::min(2 * x + 1, sw - 1);
+            const int y0 = std::min(2 * y, sh - 1), y1 = std::min(2 * y + 1, sh - 1);
+            for (int c = 0; c < 4; ++c) {
+                const int sum = src[(y0 * sw + x0) * 4 + c] + src[(y0 * sw + x1) * 4 + c]
+                              + src[(y1 * sw + x0) * 4 + c] + src[(y1 * sw + x1) * 4 + c];
+                dst[(y * dw + x) * 4 + c] = uint8_t((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+bool bakeTexturePack(const std::vector<std::string>& sources, const std::string& packPath) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    if (sources.empty()) return false;
+
+    // Sizes come from the image headers alone, so the pack's dimensions are known before anything is decoded
+    TexturePackInfo info;
+    info.layers = uint32_t(sources.size());
+    std::vector<SourceStamp> stamps(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        int w = 0, h = 0, c = 0;
+        if (!stampOf(sources[i], stamps[i]) || !stbi_info(sources[i].c_str(), &w, &h, &c)) {
+            std::fprintf(stderr, "texture pack: can't read %s\n", sources[i].c_str());
+            return false;
+        }
+        info.width = std::max(info.width, uint32_t(w));
+        info.height = std::max(info.height, uint32_t(h));
+    }
+    while ((std::max(info.width, info.height) >> info.mipLevels) > 0) ++info.mipLevels;
+
+    std::vector<uint8_t> pixels(info.totalBytes());
+    std::atomic<size_t> nextLayer{0};
+    std::atomic<bool> failed{false};
+    auto work = [&] {
+        stbi_set_flip_vertically_on_load_thread(1); // bottom row first, like every other texture we upload
+        for (size_t layer; (layer = nextLayer++) < sources.size();) {
+            int w = 0, h = 0, c = 0;
+            unsigned char* data = stbi_load(sources[layer].c_str(), &w, &h, &c, 4); // RGBA
+            if (!data) {
+                failed = true;
+                continue;
+            }
+            const int width = int(info.width), height = int(info.height);
+            uint8_t* dst = pixels.data() + layer * size_t(width) * height * 4;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    const unsigned char* src = data + (size_t(y * h / height) * w + x * w / width) * 4;
+                    std::memcpy(dst + (size_t(y) * width + x) * 4, src, 4);
+                }
+            }
+            stbi_image_free(data);
+            for (uint32_t level = 1; level < info.mipLevels; ++level) {
+                const int sw = std::max(1, width >> (level - 1)), sh = std::max(1, height >> (level - 1));
+                const int dw = std::max(1, width >> level), dh = std::max(1, height >> level);
+                const uint8_t* src = pixels.data() + info.levelOffset(level - 1) + layer * size_t(sw) * sh * 4;
+                downsample(src, sw, sh, pixels.data() + info.levelOffset(level) + layer * size_t(dw) * dh * 4, dw, dh);
+            }
+        }
+    };
+    const size_t workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, sources.size());
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) threads.emplace_back(work);
+    work();
+    for (std::thread& t : threads) t.join();
+    if (failed) {
+        std::fprintf(stderr, "texture pack: failed to decode a source image\n");
+        return false;
+    }
+
+    std::vector<uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    auto put = [&out](const auto& v) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&v);
+        out.insert(out.end(), bytes, bytes + sizeof(v));
+    };
+    for (uint32_t v : {kVersion, info.width, info.height, info.layers, info.mipLevels}) put(v);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        put(uint16_t(sources[i].size()));
+        out.insert(out.end(), sources[i].begin(), sources[i].end());
+        put(stamps[i].size);
+        put(stamps[i].mtime);
+    }
+    out.insert(out.end(), pixels.begin(), pixels.end());
+
+    fs::path tmp = packPath;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size()))) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, packPath, ec); // a pack is either complete or absent, never torn
+    if (ec) return false;
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("baked %zu textures (%ux%u, %u mips) into %s in %.1f ms\n", sources.size(), info.width, info.height,
+                info.mipLevels, packPath.c_str(), ms);
+    return true;
+}
+
+bool readTexturePackInfo(const std::string& packPath, const std::vector<std::string>& sources, TexturePackInfo& info) {
+    std::ifstream in(packPath, std::ios::binary);
+    if (!in) return false;
+    auto get = [&in](auto& v) { return bool(in.read(reinterpret_cast<char*>(&v), sizeof(v))); };
+    char magic[4];
+    uint32_t version = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, kMagic, 4) != 0 || !get(version) || version != kVersion) return false;
+    if (!get(info.width) || !get(info.height) || !get(info.layers) || !get(info.mipLevels)) return false;
+    if (info.layers != sources.size() || info.mipLevels == 0 || info.mipLevels > 32) return false;
+    std::string path;
+    for (const std::string& source : sources) {
+        uint16_t length = 0;
+        SourceStamp recorded{}, current{};
+        if (!get(length)) return false;
+        path.resize(length);
+        if (!in.read(path.data(), length) || !get(recorded.size) || !get(recorded.mtime)) return false;
+        if (path != source || !stampOf(source, current)) return false;
+        if (recorded.size != current.size || recorded.mtime != current.mtime) return false;
+    }
+    info.dataOffset = uint64_t(in.tellg());
+    std::error_code ec;
+    return fs::file_size(packPath, ec) >= info.dataOffset + info.totalBytes() && !ec;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked texture array ("texture pack"): every source image scaled (nearest) to the largest one's size with its full
+// mip chain already built, stored as raw RGBA8 so loading it is a straight copy into GPU memory.
+// File format (little endian):
+//   header:  "TCTP" magic, u32 version, u32 width, u32 height, u32 layers, u32 mip levels
+//   sources: per layer u16 path length, path, u64 file size, i64 modification time
+//   pixels:  mip-major, each level holds all layers back to back, rows bottom to top (GL's origin)
+// The recorded sources make a pack stale as soon as an image is added, removed, reordered or edited.
+struct TexturePackInfo {
+    uint32_t width = 0, height = 0, layers = 0, mipLevels = 0;
+    uint64_t dataOffset = 0; // of mip level 0 in the file
+
+    size_t levelBytes(uint32_t level) const; // all layers of one mip level
+    size_t levelOffset(uint32_t level) const; // from dataOffset
+    size_t totalBytes() const { return levelOffset(mipLevels); }
+};
+
+// Decodes and downsamples the sources on worker threads, then writes packPath atomically. Returns false if a
+// source can't be decoded or the pack can't be written.
+bool bakeTexturePack(const std::vector<std::string>& sources, const std::string& packPath);
+
+// Reads packPath's header. False if it is missing, corrupt or was baked from different sources.
+bool readTexturePackInfo(const std::string& packPath, const std::vector<std::string>& sources, TexturePackInfo& info);
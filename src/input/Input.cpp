@@ -21,6 +21,30 @@ void Input::update() {
     mousePos_   = newPos;
 }
 
+InputFrame Input::capture() const {
+    InputFrame frame;
+    for (int k = 0; k <= GLFW_KEY_LAST; ++k)
+        if (keyCurr_[k]) frame.keys[k >> 3] |= uint8_t(1u << (k & 7));
+    for (int b = 0; b <= GLFW_MOUSE_BUTTON_LAST; ++b)
+        if (mouseCurr_[b]) frame.mouseButtons |= uint8_t(1u << b);
+    frame.mousePos = mousePos_;
+    return frame;
+}
+
+void Input::inject(const InputFrame& frame) {
+    keyPrev_   = keyCurr_;
+    mousePrev_ = mouseCurr_;
+
+    for (int k = 0; k <= GLFW_KEY_LAST; ++k)
+        keyCurr_[k] = (frame.keys[k >> 3] >> (k & 7)) & 1u;
+
+    for (int b = 0; b <= GLFW_MOUSE_BUTTON_LAST; ++b)
+        mouseCurr_[b] = (frame.mouseButtons >> b) & 1u;
+
+    mouseDelta_ = frame.mousePos - mousePos_;
+    mousePos_   = frame.mousePos;
+}
+
 bool Input::isDown(Key k) const {
     return keyCurr_[static_cast<int>(k)];
 }
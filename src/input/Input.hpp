@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <GLFW/glfw3.h>
 
@@ -7,18 +8,26 @@ enum class Key : int {
     W = GLFW_KEY_W, A = GLFW_KEY_A, S = GLFW_KEY_S, D = GLFW_KEY_D, Space = GLFW_KEY_SPACE, Shift = GLFW_KEY_LEFT_SHIFT, Escape = GLFW_KEY_ESCAPE,
     P = GLFW_KEY_P, O = GLFW_KEY_O, Left = GLFW_KEY_LEFT, Right = GLFW_KEY_RIGHT, Up = GLFW_KEY_UP, Down = GLFW_KEY_DOWN, N1 = GLFW_KEY_1,
     N2 = GLFW_KEY_2, N3 = GLFW_KEY_3, N4 = GLFW_KEY_4, N5 = GLFW_KEY_5, N6 = GLFW_KEY_6, N7 = GLFW_KEY_7, N8 = GLFW_KEY_8, N9 = GLFW_KEY_9,
-    N0 = GLFW_KEY_0
+    N0 = GLFW_KEY_0, F = GLFW_KEY_F, F3 = GLFW_KEY_F3
 };
 
 enum class Mouse : int {
     Left  = GLFW_MOUSE_BUTTON_LEFT, Right = GLFW_MOUSE_BUTTON_RIGHT
 };
 
+struct InputFrame { // Everything update() polls in one tick, packed for session recording
+    std::array<uint8_t, (GLFW_KEY_LAST + 1 + 7) / 8> keys{}; // one bit per key code
+    uint8_t mouseButtons = 0; // one bit per button
+    glm::vec2 mousePos{};
+};
+
 class Input {
 public:
     explicit Input(GLFWwindow* win) { init(win); } // explicit constructor to avoid implicit conversions
 
     void update();
+    InputFrame capture() const; // current state as a recordable frame
+    void inject(const InputFrame& frame); // replacement for update() when replaying a recording
     bool isDown(Key k) const;
     bool wasPressed(Key k) const;
     bool wasReleased(Key k) const;
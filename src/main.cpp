@@ -1,7 +1,134 @@
 #include "app/Application.hpp"
+#include "app/PhysicsBench.hpp"
+#include "app/RayBench.hpp"
+#include "gfx/TexturePack.hpp"
+#include "mem/Stats.hpp"
+#include "server/WorldServer.hpp"
+#include "world/BlockRegistry.hpp"
+#include "world/TerrainGen.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <string>
+#include <vector>
 
-int main() {
-    Application app(1280, 720, "TinyCraft");
-    app.run();
+// Usage:
+//   tinycraft                                   interactive
+//   tinycraft --bench [script] [--frames N] [--size WxH]
+//                                               headless replay benchmark; default script orbits the terrain
+//   tinycraft --bench-rays [N]                  World::raycast vs raycastBatch throughput (default 1M rays)
+//   tinycraft --bench-physics [N]               Entities::step throughput with N falling boxes (default 10k)
+//   tinycraft --bake-assets                     (re)bake the block texture pack; otherwise done on first run
+//   tinycraft --record session.bin              interactive, recording every tick
+//   tinycraft --replay session.bin [--fast] [--headless]
+//                                               deterministic replay, real-time paced unless --fast
+//   tinycraft --server [port]                   authoritative world server on 127.0.0.1, no window
+//   tinycraft --connect host[:port]             client of a world server
+//   --cpu-cull                                  force the GL 3.3 CPU culling path even where GPU culling is available
+//   --save dir                                  (interactive or --server) load edits from dir and autosave them there
+//   --stats file.json                           on exit, write every resource counter and its high-water mark there
+static void dumpStats(const std::string& path) {
+    if (path.empty()) return;
+    if (writeStatsJson(path)) std::printf("resource stats written to %s\n", path.c_str());
+    else std::fprintf(stderr, "failed to write resource stats to %s\n", path.c_str());
+}
+
+int main(int argc, char** argv) {
+    bool bench = false, fast = false, headless = false;
+    bool server = false, cpuCull = false;
+    std::string scriptPath, recordPath, replayPath, connectHost, saveDir, statsPath;
+    uint16_t port = DEFAULT_PORT;
+    int frames = 600;
+    int width = 1280, height = 720;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--bench")) {
+            bench = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') scriptPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--bench-rays")) {
+            int rays = (i + 1 < argc && argv[i + 1][0] != '-') ? std::atoi(argv[++i]) : 1000000;
+            return runRayBenchmark(rays);
+        } else if (!std::strcmp(argv[i], "--bench-physics")) {
+            int entities = (i + 1 < argc && argv[i + 1][0] != '-') ? std::atoi(argv[++i]) : 10000;
+            return runPhysicsBenchmark(entities);
+        } else if (!std::strcmp(argv[i], "--bake-assets")) {
+            const std::vector<std::string> sources(std::begin(kBlockTextureFiles), std::end(kBlockTextureFiles));
+            return bakeTexturePack(sources, kBlockTexturePack) ? 0 : 1;
+        } else if (!std::strcmp(argv[i], "--server")) {
+            server = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') port = uint16_t(std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--connect") && i + 1 < argc) {
+            connectHost = argv[++i];
+            size_t colon = connectHost.find(':');
+            if (colon != std::string::npos) {
+                port = uint16_t(std::atoi(connectHost.c_str() + colon + 1));
+                connectHost.resize(colon);
+            }
+        } else if (!std::strcmp(argv[i], "--cpu-cull")) {
+            cpuCull = true;
+        } else if (!std::strcmp(argv[i], "--save") && i + 1 < argc) {
+            saveDir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--stats") && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--record") && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--fast")) {
+            fast = true;
+        } else if (!std::strcmp(argv[i], "--headless")) {
+            headless = true;
+        } else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            std::sscanf(argv[++i], "%dx%d", &width, &height);
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (frames <= 0) {
+        std::fprintf(stderr, "--frames needs a positive count\n");
+        return 2;
+    }
+
+    try {
+        if (server) {
+            WorldServer server(port, kDefaultTerrainSeed, saveDir);
+            server.run();
+            dumpStats(statsPath);
+            return 0;
+        }
+        if (bench) {
+            ReplayScript script = scriptPath.empty() ? ReplayScript::orbit(frames) : ReplayScript::load(scriptPath);
+            Application app(width, height, "TinyCraft (headless)", true);
+            if (cpuCull) app.setGpuCulling(false);
+            const int result = app.runBenchmark(script);
+            dumpStats(statsPath);
+            return result;
+        }
+        // A session replays on the terrain generated from its seed; saved or streamed chunks would make it another world
+        if ((!replayPath.empty() || !recordPath.empty()) && (!saveDir.empty() || !connectHost.empty())) {
+            std::fprintf(stderr, "--record and --replay can't be combined with --save or --connect: the world must come from the session's seed\n");
+            return 2;
+        }
+        if (headless && replayPath.empty()) {
+            std::fprintf(stderr, "--headless needs --replay or --bench\n");
+            return 2;
+        }
+        Application app(width, height, "TinyCraft", headless);
+        if (cpuCull) app.setGpuCulling(false);
+        if (!recordPath.empty()) app.startRecording(recordPath);
+        if (!replayPath.empty()) app.startReplay(replayPath, fast);
+        if (!connectHost.empty()) app.connect(connectHost, port);
+        if (!saveDir.empty()) app.enableAutosave(saveDir);
+        app.run();
+        dumpStats(statsPath); // while the app is alive, so current values show what it held
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "Arena.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstdint>
+
+static ResourceStat gArenaBytes("mem.scratch_arenas", StatUnit::CpuBytes); // buffers plus this frame's overflow, all threads
+
+LinearArena::LinearArena(size_t capacity) : buffer_(new std::byte[capacity]), capacity_(capacity) {
+    gArenaBytes.add(int64_t(capacity_));
+}
+
+LinearArena::~LinearArena() {
+    gArenaBytes.sub(int64_t(capacity_ + overflowBytes_));
+}
+
+void* LinearArena::allocBytes(size_t size, size_t align) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(buffer_.get());
+    const size_t start = ((base + offset_ + align - 1) & ~(uintptr_t(align) - 1)) - base;
+    if (start + size <= capacity_) {
+        offset_ = start + size;
+        highWater_ = std::max(highWater_, offset_ + overflowBytes_);
+        return buffer_.get() + start;
+    }
+    // Out of room this frame: heap-allocate, remember how much we needed, and grow on reset()
+    overflow_.emplace_back(new std::byte[size + align]);
+    overflowBytes_ += size + align;
+    gArenaBytes.add(int64_t(size + align));
+    highWater_ = std::max(highWater_, offset_ + overflowBytes_);
+    const uintptr_t p = reinterpret_cast<uintptr_t>(overflow_.back().get());
+    return reinterpret_cast<void*>((p + align - 1) & ~(uintptr_t(align) - 1));
+}
+
+void LinearArena::reset() {
+    if (!overflow_.empty()) {
+        const size_t old = capacity_ + overflowBytes_;
+        capacity_ = std::max(capacity_ * 2, highWater_);
+        gArenaBytes.add(int64_t(capacity_) - int64_t(old));
+        buffer_.reset(new std::byte[capacity_]);
+        overflow_.clear();
+        overflowBytes_ = 0;
+    }
+    offset_ = 0;
+}
+
+LinearArena& scratchArena() {
+    thread_local LinearArena arena(256 * 1024);
+    return arena;
+}
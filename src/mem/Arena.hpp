@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for short-lived scratch data (staging, culling lists, ...). Everything allocated is released at
+// once by reset(). If a frame needs more than the capacity, the overflow is served from the heap and the buffer is
+// grown at the next reset, so a steady workload settles at zero heap allocations.
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity);
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    template <typename T> T* alloc(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is released without running destructors");
+        return static_cast<T*>(allocBytes(count * sizeof(T), alignof(T)));
+    }
+    void reset();
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return offset_; }
+    size_t highWater() const { return highWater_; }
+
+private:
+    void* allocBytes(size_t size, size_t align);
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_;
+    size_t offset_ = 0;
+    size_t overflowBytes_ = 0;
+    size_t highWater_ = 0;
+    std::vector<std::unique_ptr<std::byte[]>> overflow_;
+};
+
+// Per-thread scratch arena. The render thread resets it every frame and after each chunk it meshes; the client's
+// meshing thread resets it after each chunk it meshes.
+LinearArena& scratchArena();
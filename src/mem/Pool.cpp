@@ -0,0 +1,68 @@
+#include "Pool.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+
+static size_t roundUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+// Leaked like the pools, which outlive every other static
+static ResourceStat& slabBytes() {
+    static ResourceStat& stat = *new ResourceStat("mem.pool_slabs", StatUnit::CpuBytes);
+    return stat;
+}
+static ResourceStat& inUseBytes() {
+    static ResourceStat& stat = *new ResourceStat("mem.pool_in_use", StatUnit::CpuBytes);
+    return stat;
+}
+
+FixedPool::FixedPool(size_t blockSize, size_t blocksPerSlab)
+    : blockSize_(roundUp(std::max(blockSize, sizeof(FreeNode)), alignof(std::max_align_t))), blocksPerSlab_(blocksPerSlab) {}
+
+FixedPool::~FixedPool() {
+    for (std::byte* slab : slabs_) ::operator delete(slab);
+    slabBytes().sub(int64_t(slabs_.size() * blocksPerSlab_ * blockSize_));
+}
+
+void* FixedPool::allocate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_) {
+        // Grow by one slab and thread all of its blocks onto the free list
+        auto* slab = static_cast<std::byte*>(::operator new(blockSize_ * blocksPerSlab_));
+        slabs_.push_back(slab);
+        slabBytes().add(int64_t(blockSize_ * blocksPerSlab_));
+        for (size_t i = blocksPerSlab_; i-- > 0;) {
+            auto* node = reinterpret_cast<FreeNode*>(slab + i * blockSize_);
+            node->next = free_;
+            free_ = node;
+        }
+    }
+    FreeNode* node = free_;
+    free_ = node->next;
+    highWater_ = std::max(highWater_, ++inUse_);
+    inUseBytes().add(int64_t(blockSize_));
+    return node;
+}
+
+void FixedPool::deallocate(void* p) {
+    if (!p) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto* node = static_cast<FreeNode*>(p);
+    node->next = free_;
+    free_ = node;
+    --inUse_;
+    inUseBytes().sub(int64_t(blockSize_));
+}
+
+size_t FixedPool::blocksInUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inUse_;
+}
+
+size_t FixedPool::blocksReserved() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size() * blocksPerSlab_;
+}
+
+size_t FixedPool::highWater() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return highWater_;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Thread-safe free list of equally sized blocks carved out of large slabs. Slabs are never returned to the OS,
+// so after warm-up a steady stream of allocate/deallocate pairs never touches the heap and cannot fragment it.
+class FixedPool {
+public:
+    FixedPool(size_t blockSize, size_t blocksPerSlab);
+    ~FixedPool();
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* p);
+
+    size_t blockSize() const { return blockSize_; }
+    size_t blocksInUse() const;
+    size_t blocksReserved() const; // in use + free
+    size_t highWater() const; // max blocks ever in use at once
+
+private:
+    struct FreeNode { FreeNode* next; };
+
+    mutable std::mutex mutex_;
+    std::vector<std::byte*> slabs_;
+    FreeNode* free_ = nullptr;
+    size_t blockSize_;
+    size_t blocksPerSlab_;
+    size_t inUse_ = 0, highWater_ = 0;
+};
+
+// One process-wide pool per block size. Intentionally leaked: pooled objects may outlive static destructors.
+template <size_t Size> FixedPool& poolFor() {
+    static FixedPool& pool = *new FixedPool(Size, Size >= 4096 ? 64 : 256);
+    return pool;
+}
+
+// Standard allocator over poolFor<sizeof(T)>(). Single-object requests (shared_ptr control blocks, map/set nodes)
+// come from the pool; array requests such as hash bucket tables go to the heap as usual.
+template <typename T> struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not pooled");
+        if (n == 1) return static_cast<T*>(poolFor<sizeof(T)>().allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (n == 1) poolFor<sizeof(T)>().deallocate(p);
+        else ::operator delete(p);
+    }
+
+    template <typename U> bool operator==(const PoolAllocator<U>&) const { return true; }
+};
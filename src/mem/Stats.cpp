@@ -0,0 +1,92 @@
+#include "Stats.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace {
+struct Registry {
+    std::mutex mutex;
+    std::vector<const ResourceStat*> stats;
+};
+
+// Leaked like the memory pools: counters are still updated while other statics are being destroyed
+Registry& registry() {
+    static Registry& r = *new Registry();
+    return r;
+}
+}
+
+ResourceStat::ResourceStat(const char* name, StatUnit unit) : name_(name), unit_(unit) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.stats.push_back(this);
+}
+
+void ResourceStat::add(int64_t delta) {
+    const int64_t now = value_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t peak = highWater_.load(std::memory_order_relaxed);
+    while (now > peak && !highWater_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+std::vector<StatSample> sampleStats() {
+    std::vector<StatSample> samples;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        samples.reserve(r.stats.size());
+        for (const ResourceStat* s : r.stats) samples.push_back(StatSample{s->name(), s->unit(), s->value(), s->highWater()});
+    }
+    std::sort(samples.begin(), samples.end(), [](const StatSample& a, const StatSample& b) { return std::strcmp(a.name, b.name) < 0; });
+    return samples;
+}
+
+const char* statUnitName(StatUnit unit) {
+    switch (unit) {
+    case StatUnit::CpuBytes: return "cpu_bytes";
+    case StatUnit::GpuBufferBytes: return "gpu_buffer_bytes";
+    case StatUnit::GpuTextureBytes: return "gpu_texture_bytes";
+    case StatUnit::Count: return "count";
+    }
+    return "unknown";
+}
+
+std::string formatStatValue(StatUnit unit, int64_t value) {
+    char buf[32];
+    if (unit == StatUnit::Count) {
+        std::snprintf(buf, sizeof(buf), "%" PRId64, value);
+    } else if (value < 1024 && value > -1024) {
+        std::snprintf(buf, sizeof(buf), "%" PRId64 " B", value);
+    } else if (value < 1024 * 1024 && value > -1024 * 1024) {
+        std::snprintf(buf, sizeof(buf), "%.1f KiB", double(value) / 1024.0);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.1f MiB", double(value) / (1024.0 * 1024.0));
+    }
+    return buf;
+}
+
+std::string statsJson() {
+    const std::vector<StatSample> samples = sampleStats();
+    int64_t totals[3] = {};
+    std::string json = "{\n  \"stats\": [\n";
+    char line[256];
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const StatSample& s = samples[i];
+        if (s.unit != StatUnit::Count) totals[int(s.unit)] += s.value;
+        std::snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %" PRId64 ", \"high_water\": %" PRId64 "}%s\n",
+                      s.name, statUnitName(s.unit), s.value, s.highWater, i + 1 < samples.size() ? "," : "");
+        json += line;
+    }
+    std::snprintf(line, sizeof(line), "  ],\n  \"totals\": {\"cpu_bytes\": %" PRId64 ", \"gpu_buffer_bytes\": %" PRId64 ", \"gpu_texture_bytes\": %" PRId64 "}\n}\n",
+                  totals[0], totals[1], totals[2]);
+    json += line;
+    return json;
+}
+
+bool writeStatsJson(const std::string& path) {
+    const std::string json = statsJson();
+    std::ofstream out(path, std::ios::trunc);
+    return bool(out.write(json.data(), std::streamsize(json.size())));
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class StatUnit : uint8_t { CpuBytes, GpuBufferBytes, GpuTextureBytes, Count };
+
+// One process-wide resource counter with its high-water mark. Subsystems define their counters as statics next
+// to the code that allocates, e.g. `static ResourceStat gFoo("gfx.foo", StatUnit::GpuBufferBytes);`, and add or
+// subtract as they allocate and free. Updates are relaxed atomics, so they are cheap enough for allocation paths
+// and safe from any thread.
+class ResourceStat {
+public:
+    ResourceStat(const char* name, StatUnit unit); // registers itself; needs static storage duration
+    ResourceStat(const ResourceStat&) = delete;
+    ResourceStat& operator=(const ResourceStat&) = delete;
+
+    void add(int64_t delta);
+    void sub(int64_t delta) { add(-delta); }
+    void track(int64_t& reported, int64_t now) { add(now - reported); reported = now; } // for owners that know their total
+
+    const char* name() const { return name_; }
+    StatUnit unit() const { return unit_; }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+    int64_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+private:
+    const char* name_;
+    StatUnit unit_;
+    std::atomic<int64_t> value_{0};
+    std::atomic<int64_t> highWater_{0};
+};
+
+struct StatSample {
+    const char* name;
+    StatUnit unit;
+    int64_t value, highWater;
+};
+
+std::vector<StatSample> sampleStats(); // every registered counter, sorted by name
+const char* statUnitName(StatUnit unit); // "cpu_bytes", "gpu_buffer_bytes", "gpu_texture_bytes", "count"
+std::string formatStatValue(StatUnit unit, int64_t value); // "1.5 MiB" for bytes, the plain number for counts
+// {"stats": [{"name", "unit", "value", "high_water"}, ...], "totals": {"cpu_bytes": n, ...}}
+std::string statsJson();
+bool writeStatsJson(const std::string& path);
@@ -0,0 +1,35 @@
+#include "Connection.hpp"
+
+Connection::Connection(Socket socket) : socket_(std::move(socket)) {
+    socket_.setNonBlocking();
+}
+
+bool Connection::flush() {
+    while (outOffset_ < outbox_.size()) {
+        long n = socket_.send(outbox_.data() + outOffset_, outbox_.size() - outOffset_);
+        if (n < 0) return false;
+        if (n == 0) break; // kernel buffer full, try again next tick
+        outOffset_ += size_t(n);
+        bytesSent_ += uint64_t(n);
+    }
+    if (outOffset_ == outbox_.size()) {
+        outbox_.clear();
+        outOffset_ = 0;
+    }
+    return true;
+}
+
+bool Connection::receive(std::vector<Message>& out) {
+    // The previous batch is done with now; shift the partial frame down (no reallocation once the inbox has grown)
+    inbox_.erase(inbox_.begin(), inbox_.begin() + inboxConsumed_);
+    inboxConsumed_ = 0;
+    uint8_t buf[16384];
+    for (;;) {
+        long n = socket_.recv(buf, sizeof(buf));
+        if (n < 0) return false;
+        if (n == 0) break;
+        inbox_.insert(inbox_.end(), buf, buf + n);
+        bytesReceived_ += uint64_t(n);
+    }
+    return extractMessages(inbox_, inboxConsumed_, out);
+}
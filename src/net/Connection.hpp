@@ -0,0 +1,30 @@
+#pragma once
+#include "Socket.hpp"
+#include "Protocol.hpp"
+#include <cstdint>
+#include <vector>
+
+class Connection { // Non-blocking framed message stream over a Socket
+public:
+    explicit Connection(Socket socket);
+
+    std::vector<uint8_t>& outbox() { return outbox_; } // append encoded frames here, then flush()
+    bool flush(); // writes as much of the outbox as the socket takes; false once the peer is gone
+    // Appends every complete message; false once the peer is gone. Message bodies point into the inbox and stay
+    // valid until the next receive().
+    bool receive(std::vector<Message>& out);
+    bool hasPendingOutput() const { return outOffset_ < outbox_.size(); }
+
+    int fd() const { return socket_.fd(); }
+    uint64_t bytesSent() const { return bytesSent_; }
+    uint64_t bytesReceived() const { return bytesReceived_; }
+
+private:
+    Socket socket_;
+    std::vector<uint8_t> inbox_;
+    size_t inboxConsumed_ = 0; // prefix of inbox_ handed out by the last receive()
+    std::vector<uint8_t> outbox_;
+    size_t outOffset_ = 0; // bytes of outbox_ already on the wire
+    uint64_t bytesSent_ = 0;
+    uint64_t bytesReceived_ = 0;
+};
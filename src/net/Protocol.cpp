@@ -0,0 +1,99 @@
+#include "Protocol.hpp"
+#include "../world/ChunkCodec.hpp"
+#include "../world/BlockRegistry.hpp"
+
+static constexpr uint32_t kMaxBody = 1u << 20; // anything bigger is a corrupt stream, not a real message
+
+static void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(uint8_t(v >> (8 * i)));
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+static void putPos(std::vector<uint8_t>& out, const glm::ivec3& pos) {
+    put32(out, uint32_t(pos.x));
+    put32(out, uint32_t(pos.y));
+    put32(out, uint32_t(pos.z));
+}
+
+static glm::ivec3 getPos(const uint8_t* p) {
+    return glm::ivec3(int32_t(get32(p)), int32_t(get32(p + 4)), int32_t(get32(p + 8)));
+}
+
+// Reserves the frame header, lets body() append, then patches the length in
+template <typename Body> static void frame(std::vector<uint8_t>& out, MsgType type, Body body) {
+    size_t start = out.size();
+    put32(out, 0);
+    out.push_back(uint8_t(type));
+    body();
+    uint32_t len = uint32_t(out.size() - start - 5);
+    for (int i = 0; i < 4; ++i) out[start + i] = uint8_t(len >> (8 * i));
+}
+
+void appendChunkMsg(std::vector<uint8_t>& out, const ChunkCoord& coord, const Chunk& chunk) {
+    frame(out, MsgType::ChunkData, [&] {
+        putPos(out, glm::ivec3(coord.x, coord.y, coord.z));
+        encodeChunk(chunk, out);
+    });
+}
+
+void appendDeltasMsg(std::vector<uint8_t>& out, uint32_t tick, const std::vector<BlockDelta>& deltas) {
+    frame(out, MsgType::BlockDeltas, [&] {
+        put32(out, tick);
+        put32(out, uint32_t(deltas.size()));
+        for (const BlockDelta& d : deltas) {
+            putPos(out, d.pos);
+            out.push_back(uint8_t(d.id));
+        }
+    });
+}
+
+void appendEditMsg(std::vector<uint8_t>& out, const BlockDelta& edit) {
+    frame(out, MsgType::EditRequest, [&] {
+        putPos(out, edit.pos);
+        out.push_back(uint8_t(edit.id));
+    });
+}
+
+bool parseChunkMsg(std::span<const uint8_t> body, ChunkCoord& coord, Chunk& chunk) {
+    if (body.size() < 12) return false;
+    glm::ivec3 c = getPos(body.data());
+    coord = ChunkCoord{c.x, c.y, c.z};
+    return decodeChunk(body.data() + 12, body.size() - 12, chunk);
+}
+
+bool parseDeltasMsg(std::span<const uint8_t> body, uint32_t& tick, std::vector<BlockDelta>& deltas) {
+    if (body.size() < 8) return false;
+    tick = get32(body.data());
+    uint32_t count = get32(body.data() + 4);
+    if (body.size() != 8 + size_t(count) * 13) return false;
+    deltas.clear();
+    deltas.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* p = body.data() + 8 + i * 13;
+        deltas.push_back(BlockDelta{getPos(p), static_cast<BlockId>(p[12])});
+    }
+    return true;
+}
+
+bool parseEditMsg(std::span<const uint8_t> body, BlockDelta& edit) {
+    if (body.size() != 13) return false;
+    edit = BlockDelta{getPos(body.data()), static_cast<BlockId>(body[12])};
+    return edit.id == BlockId::Air || isPlaceable(edit.id); // the server would apply and broadcast any other byte
+}
+
+bool extractMessages(std::span<const uint8_t> buf, size_t& consumed, std::vector<Message>& out) {
+    size_t p = 0;
+    consumed = 0;
+    while (buf.size() - p >= 5) {
+        uint32_t len = get32(buf.data() + p);
+        if (len > kMaxBody) return false;
+        if (buf.size() - p - 5 < len) break; // partial frame, wait for more bytes
+        out.push_back(Message{static_cast<MsgType>(buf[p + 4]), buf.subspan(p + 5, len)});
+        p += 5 + len;
+        consumed = p;
+    }
+    return true;
+}
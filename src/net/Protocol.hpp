@@ -0,0 +1,39 @@
+#pragma once
+#include "../world/Block.hpp"
+#include "../world/Chunk.hpp"
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+constexpr uint16_t DEFAULT_PORT = 41000;
+
+// Wire format: every message is framed as u32 body length, u8 MsgType, body. All integers little endian.
+enum class MsgType : uint8_t {
+    ChunkData = 1,   // server -> client: i32 x,y,z + RLE cells (see ChunkCodec), sent the first time a client sees a chunk
+    BlockDeltas = 2, // server -> client: u32 tick, u32 count, count * (i32 x,y,z, u8 id); one batch per server tick
+    EditRequest = 3, // client -> server: i32 x,y,z, u8 id (Air = break)
+};
+
+struct BlockDelta {
+    glm::ivec3 pos;
+    BlockId id;
+};
+
+struct Message {
+    MsgType type;
+    std::span<const uint8_t> body; // points into the receive buffer it was extracted from
+};
+
+void appendChunkMsg(std::vector<uint8_t>& out, const ChunkCoord& coord, const Chunk& chunk);
+void appendDeltasMsg(std::vector<uint8_t>& out, uint32_t tick, const std::vector<BlockDelta>& deltas);
+void appendEditMsg(std::vector<uint8_t>& out, const BlockDelta& edit);
+
+bool parseChunkMsg(std::span<const uint8_t> body, ChunkCoord& coord, Chunk& chunk);
+bool parseDeltasMsg(std::span<const uint8_t> body, uint32_t& tick, std::vector<BlockDelta>& deltas);
+bool parseEditMsg(std::span<const uint8_t> body, BlockDelta& edit); // false for ids the block registry doesn't know
+
+// Appends every complete frame in buf to out without copying bodies, and sets consumed to the bytes they span
+// (any partial frame stays after that). The caller drops the consumed prefix once it is done with out.
+// False on a corrupt frame.
+bool extractMessages(std::span<const uint8_t> buf, size_t& consumed, std::vector<Message>& out);
@@ -0,0 +1,95 @@
+#include "Socket.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef MSG_NOSIGNAL
+static constexpr int kSendFlags = MSG_NOSIGNAL; // a dead peer must not kill the process with SIGPIPE
+#else
+static constexpr int kSendFlags = 0; // macOS: SO_NOSIGPIPE is set per socket instead
+#endif
+
+static void configure(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // deltas are small and latency matters
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+Socket::~Socket() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+Socket::Socket(Socket&& other) noexcept : fd_(other.fd_) {
+    other.fd_ = -1;
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+Socket Socket::listen(uint16_t port) {
+    Socket s(::socket(AF_INET, SOCK_STREAM, 0));
+    if (!s.valid()) throw std::runtime_error("socket() failed");
+    int one = 1;
+    setsockopt(s.fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(s.fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        throw std::runtime_error("Cannot bind port " + std::to_string(port));
+    if (::listen(s.fd_, 16) < 0) throw std::runtime_error("listen() failed");
+    s.setNonBlocking();
+    return s;
+}
+
+Socket Socket::connect(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res)
+        throw std::runtime_error("Cannot resolve " + host);
+    Socket s(::socket(res->ai_family, res->ai_socktype, res->ai_protocol));
+    bool ok = s.valid() && ::connect(s.fd_, res->ai_addr, res->ai_addrlen) == 0;
+    freeaddrinfo(res);
+    if (!ok) throw std::runtime_error("Cannot connect to " + host + ":" + std::to_string(port));
+    configure(s.fd_);
+    return s;
+}
+
+Socket Socket::accept() const {
+    Socket s(::accept(fd_, nullptr, nullptr));
+    if (s.valid()) configure(s.fd_);
+    return s;
+}
+
+void Socket::setNonBlocking() {
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+}
+
+long Socket::send(const void* data, size_t size) const {
+    ssize_t n = ::send(fd_, data, size, kSendFlags);
+    if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    return long(n);
+}
+
+long Socket::recv(void* data, size_t size) const {
+    ssize_t n = ::recv(fd_, data, size, 0);
+    if (n == 0) return -1; // orderly shutdown by the peer
+    if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    return long(n);
+}
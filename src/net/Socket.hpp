@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Socket { // Move-only owner of a POSIX TCP socket
+public:
+    Socket() = default;
+    explicit Socket(int fd) : fd_(fd) {}
+    ~Socket();
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+
+    static Socket listen(uint16_t port); // binds 127.0.0.1 only; throws std::runtime_error
+    static Socket connect(const std::string& host, uint16_t port); // throws std::runtime_error
+    Socket accept() const; // invalid socket if nothing is pending (listener is non-blocking)
+
+    void setNonBlocking();
+    long send(const void* data, size_t size) const; // bytes written, 0 if it would block, -1 on error
+    long recv(void* data, size_t size) const; // bytes read, 0 if it would block, -1 on error or EOF
+    bool valid() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+private:
+    int fd_ = -1;
+};
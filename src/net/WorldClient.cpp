@@ -0,0 +1,99 @@
+#include "WorldClient.hpp"
+#include "../gfx/ChunkMesher.hpp"
+#include "../mem/Arena.hpp"
+#include <poll.h>
+#include <algorithm>
+#include <cstdio>
+
+WorldClient::WorldClient(const std::string& host, uint16_t port)
+    : conn_(Socket::connect(host, port)), thread_(&WorldClient::networkLoop, this) {}
+
+WorldClient::~WorldClient() {
+    stop_ = true;
+    if (thread_.joinable()) thread_.join();
+}
+
+void WorldClient::sendEdit(const BlockDelta& edit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    outgoing_.push_back(edit);
+}
+
+void WorldClient::takeUpdates(std::vector<ChunkUpdate>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (ChunkUpdate& u : out) {
+        u.mesh.clear();
+        spareMeshes_.push_back(std::move(u.mesh));
+    }
+    out.clear();
+    out.swap(ready_);
+}
+
+void WorldClient::networkLoop() {
+    // Everything below keeps its capacity from one iteration to the next
+    std::vector<Message> messages;
+    std::vector<BlockDelta> deltas, edits;
+    std::vector<ChunkCoord> touched, dirty;
+    std::vector<ChunkUpdate> finished;
+    std::vector<std::vector<BlockInstance>> meshes;
+    auto touch = [&touched](const ChunkCoord& c) {
+        if (std::find(touched.begin(), touched.end(), c) == touched.end()) touched.push_back(c);
+    };
+    while (!stop_ && connected_) {
+        pollfd pfd{conn_.fd(), short(POLLIN | (conn_.hasPendingOutput() ? POLLOUT : 0)), 0};
+        poll(&pfd, 1, 10); // short timeout so queued edits and stop requests are picked up quickly
+
+        messages.clear();
+        if (!conn_.receive(messages)) connected_ = false;
+        touched.clear();
+        for (const Message& msg : messages) {
+            if (msg.type == MsgType::ChunkData) {
+                ChunkCoord coord;
+                Chunk chunk;
+                if (parseChunkMsg(msg.body, coord, chunk)) {
+                    mirror_.replaceChunk(coord, chunk);
+                    touch(coord);
+                }
+            } else if (msg.type == MsgType::BlockDeltas) {
+                uint32_t tick = 0;
+                if (parseDeltasMsg(msg.body, tick, deltas)) {
+                    for (const BlockDelta& d : deltas) mirror_.add(Block{d.pos, d.id});
+                }
+            }
+        }
+        mirror_.takeDirtyChunks(dirty);
+        for (const ChunkCoord& coord : dirty) touch(coord);
+
+        if (!touched.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_); // recycle buffers the render thread is done with
+                while (meshes.size() < touched.size() && !spareMeshes_.empty()) {
+                    meshes.push_back(std::move(spareMeshes_.back()));
+                    spareMeshes_.pop_back();
+                }
+            }
+            for (const ChunkCoord& coord : touched) {
+                ChunkUpdate update{coord, *mirror_.chunk(coord), {}};
+                if (!meshes.empty()) {
+                    update.mesh = std::move(meshes.back());
+                    meshes.pop_back();
+                }
+                meshChunk(coord, update.chunk, update.mesh);
+                scratchArena().reset(); // one chunk per work item
+                finished.push_back(std::move(update));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (ChunkUpdate& u : finished) ready_.push_back(std::move(u));
+            edits.swap(outgoing_);
+        }
+        finished.clear();
+        for (const BlockDelta& e : edits) appendEditMsg(conn_.outbox(), e);
+        edits.clear();
+        if (!conn_.flush()) connected_ = false;
+        bytesReceived_ = conn_.bytesReceived();
+        bytesSent_ = conn_.bytesSent();
+    }
+    if (!connected_) std::fprintf(stderr, "lost connection to world server\n");
+}
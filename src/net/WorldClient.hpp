@@ -0,0 +1,47 @@
+#pragma once
+#include "Connection.hpp"
+#include "../gfx/InstanceBuffer.hpp"
+#include "../world/World.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ChunkUpdate { // A chunk as the server last described it, already meshed
+    ChunkCoord coord;
+    Chunk chunk;
+    std::vector<BlockInstance> mesh;
+};
+
+// Client side of WorldServer. A background thread owns the socket, decodes incoming chunks and deltas into
+// its own mirror of the world and meshes every touched chunk, so the render thread only swaps results in.
+class WorldClient {
+public:
+    WorldClient(const std::string& host, uint16_t port); // throws std::runtime_error if the server is unreachable
+    ~WorldClient();
+    WorldClient(const WorldClient&) = delete;
+    WorldClient& operator=(const WorldClient&) = delete;
+
+    void sendEdit(const BlockDelta& edit); // Air = break
+    // Replaces out with everything finished since the last call. Pass the same vector every frame: the meshes
+    // of the previous batch go back to the network thread for reuse, so steady streaming doesn't allocate.
+    void takeUpdates(std::vector<ChunkUpdate>& out);
+    bool connected() const { return connected_; }
+    uint64_t bytesReceived() const { return bytesReceived_; }
+    uint64_t bytesSent() const { return bytesSent_; }
+
+private:
+    void networkLoop();
+
+    Connection conn_;
+    World mirror_; // network thread only
+    std::mutex mutex_; // guards outgoing_, ready_ and spareMeshes_
+    std::vector<BlockDelta> outgoing_;
+    std::vector<ChunkUpdate> ready_;
+    std::vector<std::vector<BlockInstance>> spareMeshes_; // emptied mesh buffers handed back by takeUpdates()
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> connected_{true};
+    std::atomic<uint64_t> bytesReceived_{0}, bytesSent_{0};
+    std::thread thread_; // last member: starts once everything above is constructed
+};
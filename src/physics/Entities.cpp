@@ -0,0 +1,268 @@
+#include "Entities.hpp"
+#include "../world/BlockRegistry.hpp"
+#include "../world/WorkerPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Cells are unit cubes centred on integer positions: cell i spans [i - 0.5, i + 0.5] on each axis
+static int cellAt(float c) { return int(std::floor(c + 0.5f)); }
+static constexpr float EPS = 1e-4f; // boxes touching a face are not inside the cell behind it
+
+namespace {
+// Solid-cell lookups with the last chunk cached: a sweep visits neighbouring cells, nearly always in one chunk
+struct SolidCells {
+    const World& world;
+    ChunkCoord coord{};
+    const Chunk* chunk = nullptr;
+    bool cached = false;
+
+    bool solid(const glm::ivec3& cell) {
+        const ChunkCoord c = chunkOf(cell);
+        if (!cached || !(c == coord)) {
+            coord = c;
+            chunk = world.chunk(c);
+            cached = true;
+        }
+        return chunk && isSolid(chunk->get(cell - chunkOrigin(c)));
+    }
+};
+}
+
+// How far the box [min, max] can move by d along axis before it hits a solid cell. Only the slab of cells
+// between the leading face and its destination is visited, nearest first.
+static float sweepAxis(SolidCells& cells, const glm::vec3& min, const glm::vec3& max, int axis, float d) {
+    const int b = (axis + 1) % 3, c = (axis + 2) % 3;
+    const int b0 = cellAt(min[b] + EPS), b1 = cellAt(max[b] - EPS);
+    const int c0 = cellAt(min[c] + EPS), c1 = cellAt(max[c] - EPS);
+    auto blocked = [&](int i) {
+        glm::ivec3 cell;
+        cell[axis] = i;
+        for (cell[b] = b0; cell[b] <= b1; ++cell[b]) {
+            for (cell[c] = c0; cell[c] <= c1; ++cell[c]) {
+                if (cells.solid(cell)) return true;
+            }
+        }
+        return false;
+    };
+    if (d > 0.0f) {
+        const float lead = max[axis];
+        const int last = int(std::ceil(lead + d + 0.5f)) - 1;
+        for (int i = int(std::ceil(lead + 0.5f - EPS)); i <= last; ++i) {
+            if (blocked(i)) return std::max(0.0f, float(i) - 0.5f - lead);
+        }
+    } else {
+        const float lead = min[axis];
+        const int last = int(std::floor(lead + d - 0.5f)) + 1;
+        for (int i = int(std::floor(lead - 0.5f + EPS)); i >= last; --i) {
+            if (blocked(i)) return std::min(0.0f, float(i) + 0.5f - lead);
+        }
+    }
+    return d;
+}
+
+// Whether any solid cell overlaps the box [min, max]; lo..hi receives the range of cells those span
+static bool solidBounds(SolidCells& cells, const glm::vec3& min, const glm::vec3& max, glm::ivec3& lo, glm::ivec3& hi) {
+    bool found = false;
+    glm::ivec3 cell;
+    for (cell.y = cellAt(min.y + EPS); cell.y <= cellAt(max.y - EPS); ++cell.y) {
+        for (cell.z = cellAt(min.z + EPS); cell.z <= cellAt(max.z - EPS); ++cell.z) {
+            for (cell.x = cellAt(min.x + EPS); cell.x <= cellAt(max.x - EPS); ++cell.x) {
+                if (!cells.solid(cell)) continue;
+                lo = found ? glm::min(lo, cell) : cell;
+                hi = found ? glm::max(hi, cell) : cell;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+static bool anySolid(SolidCells& cells, const glm::vec3& min, const glm::vec3& max) {
+    glm::ivec3 cell;
+    for (cell.y = cellAt(min.y + EPS); cell.y <= cellAt(max.y - EPS); ++cell.y) {
+        for (cell.z = cellAt(min.z + EPS); cell.z <= cellAt(max.z - EPS); ++cell.z) {
+            for (cell.x = cellAt(min.x + EPS); cell.x <= cellAt(max.x - EPS); ++cell.x) {
+                if (cells.solid(cell)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Frees a box that overlaps solid cells. It climbs on top of them if that is at most one layer up and ends in free
+// space; otherwise it takes the shortest move clear of them that ends in free space: below them or beside them.
+// push gets the direction moved (one component +-1, or zero). Returns false if there is no way out, e.g. for a box
+// walled in under a ceiling; it is then left where it is rather than tunnelling through.
+static bool pushOut(SolidCells& cells, glm::vec3& pos, const glm::vec3& half, glm::ivec3& push) {
+    push = glm::ivec3(0);
+    glm::ivec3 lo, hi;
+    if (!solidBounds(cells, pos - half, pos + half, lo, hi)) return true;
+    auto freeAfter = [&](int axis, float move) {
+        glm::vec3 moved = pos;
+        moved[axis] += move;
+        return !anySolid(cells, moved - half, moved + half);
+    };
+    const float lift = float(hi.y) + 0.5f - (pos.y - half.y);
+    if (lift <= 1.0f + EPS && freeAfter(1, lift)) {
+        pos.y += lift;
+        push.y = 1;
+        return true;
+    }
+    float best = INFINITY, bestMove = 0.0f;
+    int bestAxis = -1;
+    for (int axis : {1, 0, 2}) {
+        for (int dir : {1, -1}) {
+            if (axis == 1 && dir > 0) continue; // up was tried above
+            const float move = dir > 0 ? float(hi[axis]) + 0.5f - (pos[axis] - half[axis])
+                                       : float(lo[axis]) - 0.5f - (pos[axis] + half[axis]);
+            if (!(std::abs(move) < best) || !freeAfter(axis, move)) continue;
+            best = std::abs(move);
+            bestMove = move;
+            bestAxis = axis;
+        }
+    }
+    if (bestAxis < 0) return false;
+    pos[bestAxis] += bestMove;
+    push[bestAxis] = bestMove > 0.0f ? 1 : -1;
+    return true;
+}
+
+bool boxHitsSolid(const World& world, const glm::vec3& min, const glm::vec3& max) {
+    SolidCells cells{world};
+    return anySolid(cells, min, max);
+}
+
+EntityId Entities::spawn(const glm::vec3& centre, const glm::vec3& halfExtents, float gravityScale) {
+    EntityId id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        id = EntityId(slots_.size());
+        slots_.push_back(NO_SLOT);
+    }
+    slots_[id] = uint32_t(ids_.size());
+    ids_.push_back(id);
+    posX_.push_back(centre.x), posY_.push_back(centre.y), posZ_.push_back(centre.z);
+    velX_.push_back(0.0f), velY_.push_back(0.0f), velZ_.push_back(0.0f);
+    halfX_.push_back(halfExtents.x), halfY_.push_back(halfExtents.y), halfZ_.push_back(halfExtents.z);
+    gravity_.push_back(gravityScale);
+    onGround_.push_back(0);
+    placed_.push_back(1);
+    return id;
+}
+
+void Entities::despawn(EntityId id) {
+    if (!alive(id)) return;
+    const uint32_t slot = slots_[id];
+    const uint32_t last = uint32_t(ids_.size() - 1);
+    auto moveLast = [slot, last](auto& column) {
+        column[slot] = column[last];
+        column.pop_back();
+    };
+    moveLast(posX_), moveLast(posY_), moveLast(posZ_);
+    moveLast(velX_), moveLast(velY_), moveLast(velZ_);
+    moveLast(halfX_), moveLast(halfY_), moveLast(halfZ_);
+    moveLast(gravity_);
+    moveLast(onGround_);
+    moveLast(placed_);
+    moveLast(ids_);
+    if (slot != last) slots_[ids_[slot]] = slot;
+    slots_[id] = NO_SLOT;
+    freeIds_.push_back(id);
+}
+
+bool Entities::alive(EntityId id) const {
+    return id < slots_.size() && slots_[id] != NO_SLOT;
+}
+
+glm::vec3 Entities::position(EntityId id) const {
+    const uint32_t s = slots_[id];
+    return glm::vec3(posX_[s], posY_[s], posZ_[s]);
+}
+
+void Entities::setPosition(EntityId id, const glm::vec3& centre) {
+    const uint32_t s = slots_[id];
+    posX_[s] = centre.x, posY_[s] = centre.y, posZ_[s] = centre.z;
+    placed_[s] = 1;
+}
+
+glm::vec3 Entities::velocity(EntityId id) const {
+    const uint32_t s = slots_[id];
+    return glm::vec3(velX_[s], velY_[s], velZ_[s]);
+}
+
+void Entities::setVelocity(EntityId id, const glm::vec3& velocity) {
+    const uint32_t s = slots_[id];
+    velX_[s] = velocity.x, velY_[s] = velocity.y, velZ_[s] = velocity.z;
+}
+
+glm::vec3 Entities::halfExtents(EntityId id) const {
+    const uint32_t s = slots_[id];
+    return glm::vec3(halfX_[s], halfY_[s], halfZ_[s]);
+}
+
+void Entities::setGravityScale(EntityId id, float scale) {
+    gravity_[slots_[id]] = scale;
+}
+
+bool Entities::onGround(EntityId id) const {
+    return onGround_[slots_[id]] != 0;
+}
+
+void Entities::step(const World& world, float dt) {
+    const size_t n = ids_.size();
+    if (n == 0 || dt <= 0.0f) return;
+
+    // Gravity: a branch-free pass over two float arrays
+    float* vy = velY_.data();
+    const float* g = gravity_.data();
+    for (size_t i = 0; i < n; ++i) vy[i] = std::max(vy[i] - GRAVITY * g[i] * dt, -TERMINAL_SPEED);
+
+    const bool worldChanged = &world != steppedWorld_ || world.version() != steppedVersion_;
+    steppedWorld_ = &world;
+    steppedVersion_ = world.version();
+
+    // Collision reads the world and writes only each entity's own slots, so slices run in parallel
+    constexpr size_t ENTITIES_PER_THREAD = 256; // below this, handing out slices costs more than it saves
+    const size_t workers = std::clamp<size_t>(n / ENTITIES_PER_THREAD, 1, workerPool().size());
+    workerPool().run(workers, [&](size_t w) { collide(world, n * w / workers, n * (w + 1) / workers, dt, worldChanged); });
+}
+
+void Entities::collide(const World& world, size_t begin, size_t end, float dt, bool checkAll) {
+    SolidCells cells{world};
+    for (size_t i = begin; i < end; ++i) {
+        glm::vec3 pos(posX_[i], posY_[i], posZ_[i]);
+        glm::vec3 vel(velX_[i], velY_[i], velZ_[i]);
+        const glm::vec3 half(halfX_[i], halfY_[i], halfZ_[i]);
+        bool grounded = false;
+        // A box inside solid cells (spawned there, or a block placed around it) is pushed out first. The sweeps below
+        // only look ahead of the box, so without this it could fall straight through the ground.
+        if (checkAll || placed_[i]) {
+            glm::ivec3 push;
+            const bool freed = pushOut(cells, pos, half, push);
+            for (int axis = 0; axis < 3; ++axis) {
+                if (float(push[axis]) * vel[axis] < 0.0f) vel[axis] = 0.0f; // don't head straight back in
+            }
+            grounded = push.y > 0;
+            if (!freed) { // stuck: hold it in place (rather than sinking) and try again next step
+                vel.y = std::max(vel.y, 0.0f);
+                grounded = true;
+            }
+            placed_[i] = !freed;
+        }
+        for (int axis : {1, 0, 2}) { // landing is resolved before sliding along walls
+            const float want = vel[axis] * dt;
+            if (want == 0.0f) continue;
+            const float moved = sweepAxis(cells, pos - half, pos + half, axis, want);
+            pos[axis] += moved;
+            if (moved != want) {
+                grounded |= axis == 1 && want < 0.0f;
+                vel[axis] = 0.0f;
+            }
+        }
+        posX_[i] = pos.x, posY_[i] = pos.y, posZ_[i] = pos.z;
+        velX_[i] = vel.x, velY_[i] = vel.y, velZ_[i] = vel.z;
+        onGround_[i] = grounded;
+    }
+}
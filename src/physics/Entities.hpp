@@ -0,0 +1,60 @@
+#pragma once
+#include "../world/World.hpp"
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <vector>
+
+using EntityId = uint32_t;
+constexpr EntityId NO_ENTITY = ~0u;
+
+// Axis-aligned boxes moving through the voxel grid: the player, and later dropped items, mobs, ...
+// Components live in structure-of-arrays form in dense slots (despawning moves the last entity into the gap; ids
+// stay valid), so step() integrates with plain loops over float arrays and splits collision across threads when
+// there are many entities.
+// Collision is a swept AABB against solid cells (isSolid in BlockRegistry), one axis at a time in y, x, z order:
+// each move only visits the cells the box sweeps through, stops flush against the first solid one and zeroes
+// that velocity component. A box that starts a step inside solid cells is first lifted onto them if they are at most
+// one layer deep and there is room above, otherwise pushed out below or beside them by the shortest move that ends in
+// free space; one with no way out stays put until the cells around it change.
+class Entities {
+public:
+    EntityId spawn(const glm::vec3& centre, const glm::vec3& halfExtents, float gravityScale = 1.0f);
+    void despawn(EntityId id); // the id may be handed out again by a later spawn
+    bool alive(EntityId id) const;
+    size_t size() const { return ids_.size(); }
+
+    glm::vec3 position(EntityId id) const; // box centre
+    void setPosition(EntityId id, const glm::vec3& centre);
+    glm::vec3 velocity(EntityId id) const;
+    void setVelocity(EntityId id, const glm::vec3& velocity);
+    glm::vec3 halfExtents(EntityId id) const;
+    void setGravityScale(EntityId id, float scale); // 0 = floats, e.g. a flying player
+    bool onGround(EntityId id) const; // the last step ended resting on a solid cell
+
+    void step(const World& world, float dt);
+
+    static constexpr float GRAVITY = 28.0f; // blocks/s^2
+    static constexpr float TERMINAL_SPEED = 60.0f; // blocks/s, falling
+
+private:
+    static constexpr uint32_t NO_SLOT = ~0u;
+
+    void collide(const World& world, size_t begin, size_t end, float dt, bool checkAll);
+
+    std::vector<float> posX_, posY_, posZ_;
+    std::vector<float> velX_, velY_, velZ_;
+    std::vector<float> halfX_, halfY_, halfZ_;
+    std::vector<float> gravity_;
+    std::vector<uint8_t> onGround_;
+    std::vector<uint8_t> placed_; // spawned or moved by setPosition() since the last step, or stuck: may start inside a block
+    std::vector<EntityId> ids_; // slot -> id
+    std::vector<uint32_t> slots_; // id -> slot, or NO_SLOT while the id is free
+    std::vector<EntityId> freeIds_;
+    // Sweeps never end a move inside a solid cell, so boxes only need the start-of-step overlap check when they
+    // were placed, or when the world's cells changed since the last step
+    const World* steppedWorld_ = nullptr;
+    uint64_t steppedVersion_ = 0;
+};
+
+// Whether any solid cell overlaps the box (touching faces don't count)
+bool boxHitsSolid(const World& world, const glm::vec3& min, const glm::vec3& max);
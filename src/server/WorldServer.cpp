@@ -0,0 +1,139 @@
+#include "WorldServer.hpp"
+#include "../world/TerrainGen.hpp"
+#include "../world/BlockRegistry.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+
+static std::atomic<bool> gStop{false};
+
+static void onSignal(int) { gStop = true; }
+
+WorldServer::WorldServer(uint16_t port, uint32_t terrainSeed, const std::string& saveDir)
+    : listener_(Socket::listen(port)), world_(makeTerrain(32, 4, terrainSeed)) {
+    if (!saveDir.empty()) {
+        size_t loaded = loadSavedChunks(saveDir, world_);
+        if (loaded) std::printf("loaded %zu saved chunks from %s\n", loaded, saveDir.c_str());
+        for (const auto& [coord, chunk] : world_.chunks()) ticker_.wakeChunk(coord); // resume flows saved mid-way
+        autosaver_ = std::make_unique<Autosaver>(saveDir);
+    }
+    world_.takeDirtyChunks(dirtyScratch_); // the server never meshes
+    std::printf("world server listening on 127.0.0.1:%u (%zu chunks, %zu blocks)\n", unsigned(port),
+                world_.chunks().size(), world_.blockCount());
+}
+
+void WorldServer::run() {
+    using Clock = std::chrono::steady_clock;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / TICK_RATE));
+    auto nextTick = Clock::now();
+    auto lastReport = Clock::now();
+    while (!gStop) {
+        auto start = Clock::now();
+        tick();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        tickMsTotal_ += ms;
+        tickMsMax_ = std::max(tickMsMax_, ms);
+        ++ticksMeasured_;
+
+        double sinceReport = std::chrono::duration<double>(Clock::now() - lastReport).count();
+        if (sinceReport >= 5.0) {
+            reportStats(sinceReport);
+            lastReport = Clock::now();
+        }
+        if (autosaver_ && tick_ % uint32_t(AUTOSAVE_INTERVAL_SECONDS * TICK_RATE) == 0) autosave();
+        nextTick += period;
+        std::this_thread::sleep_until(nextTick);
+    }
+    if (autosaver_) autosave();
+    std::printf("world server stopped after %u ticks\n", tick_);
+}
+
+void WorldServer::tick() {
+    acceptClients();
+
+    deltas_.clear();
+    for (auto& client : clients_) {
+        messages_.clear();
+        uint64_t before = client->conn.bytesReceived();
+        if (!client->conn.receive(messages_)) client.reset(); // disconnected
+        else bytesIn_ += client->conn.bytesReceived() - before;
+        for (const Message& msg : messages_) {
+            BlockDelta edit;
+            if (msg.type == MsgType::EditRequest && parseEditMsg(msg.body, edit) && applyEdit(edit)) deltas_.push_back(edit);
+        }
+    }
+    editsApplied_ += deltas_.size();
+    ticker_.tick();
+    for (const Block& b : ticker_.changes()) deltas_.push_back(BlockDelta{b.pos, b.id});
+    simChanges_ += ticker_.changes().size();
+    world_.takeDirtyChunks(dirtyScratch_);
+
+    for (auto& client : clients_) {
+        if (!client) continue;
+        batch_.clear();
+        for (const BlockDelta& d : deltas_) {
+            ChunkCoord coord = chunkOf(d.pos);
+            if (client->known.count(coord)) batch_.push_back(d);
+            else sendChunk(*client, coord); // first sight: the full chunk already contains this edit
+        }
+        if (!batch_.empty()) appendDeltasMsg(client->conn.outbox(), tick_, batch_);
+        uint64_t before = client->conn.bytesSent();
+        if (!client->conn.flush()) client.reset();
+        else bytesOut_ += client->conn.bytesSent() - before;
+    }
+    std::erase_if(clients_, [](const std::unique_ptr<Client>& c) { return !c; });
+    ++tick_;
+}
+
+void WorldServer::acceptClients() {
+    for (Socket s = listener_.accept(); s.valid(); s = listener_.accept()) {
+        auto client = std::make_unique<Client>(std::move(s));
+        for (const auto& [coord, chunk] : world_.chunks()) {
+            if (!chunk.empty()) sendChunk(*client, coord);
+        }
+        std::printf("client connected (%zu total)\n", clients_.size() + 1);
+        clients_.push_back(std::move(client));
+    }
+}
+
+void WorldServer::sendChunk(Client& client, const ChunkCoord& coord) {
+    const Chunk* chunk = world_.chunk(coord);
+    if (!chunk || !client.known.insert(coord).second) return;
+    appendChunkMsg(client.conn.outbox(), coord, *chunk);
+}
+
+bool WorldServer::applyEdit(const BlockDelta& edit) {
+    const BlockId current = world_.get(edit.pos);
+    if (edit.id == BlockId::Air) {
+        if (current == BlockId::Air) return false;
+        world_.remove(edit.pos);
+    } else {
+        if (!isReplaceable(current)) return false; // fluids give way, anything else is occupied
+        world_.add(Block{edit.pos, edit.id});
+    }
+    ticker_.wake(edit.pos);
+    return true;
+}
+
+void WorldServer::autosave() {
+    auto start = std::chrono::steady_clock::now();
+    auto snapshot = world_.snapshotUnsaved();
+    size_t chunks = snapshot.size();
+    autosaver_->submit(std::move(snapshot));
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (chunks) std::printf("autosave: handed %zu chunks to the writer in %.1f us\n", chunks, us);
+}
+
+void WorldServer::reportStats(double seconds) {
+    std::printf("clients=%zu tick_ms mean=%.3f max=%.3f edits=%llu sim_changes=%llu active_cells=%zu out=%.1f KB/s in=%.1f KB/s\n",
+                clients_.size(), ticksMeasured_ ? tickMsTotal_ / double(ticksMeasured_) : 0.0, tickMsMax_,
+                (unsigned long long)editsApplied_, (unsigned long long)simChanges_, ticker_.activeCells(),
+                double(bytesOut_) / 1024.0 / seconds, double(bytesIn_) / 1024.0 / seconds);
+    std::fflush(stdout);
+    bytesOut_ = bytesIn_ = ticksMeasured_ = editsApplied_ = simChanges_ = 0;
+    tickMsTotal_ = tickMsMax_ = 0.0;
+}
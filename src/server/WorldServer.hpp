@@ -0,0 +1,50 @@
+#pragma once
+#include "../net/Connection.hpp"
+#include "../world/World.hpp"
+#include "../world/Autosave.hpp"
+#include "../world/BlockTicker.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+// Authoritative world process. Clients get every chunk they have not seen yet as a compressed ChunkData message,
+// and all edits accepted during a tick go out together as one BlockDeltas batch per client.
+class WorldServer {
+public:
+    WorldServer(uint16_t port, uint32_t terrainSeed, const std::string& saveDir = ""); // empty saveDir = no persistence
+    void run(); // ticks until SIGINT/SIGTERM
+
+    static constexpr int TICK_RATE = BlockTicker::TICK_RATE; // ticks per second
+
+private:
+    struct Client {
+        explicit Client(Socket socket) : conn(std::move(socket)) {}
+        Connection conn;
+        std::unordered_set<ChunkCoord, ChunkCoordHash, std::equal_to<ChunkCoord>, PoolAllocator<ChunkCoord>> known; // chunks this client already holds
+    };
+
+    void tick();
+    void acceptClients();
+    void sendChunk(Client& client, const ChunkCoord& coord);
+    bool applyEdit(const BlockDelta& edit); // false if rejected (occupied / already empty)
+    void reportStats(double seconds);
+    void autosave();
+
+    Socket listener_;
+    World world_;
+    BlockTicker ticker_{world_}; // runs once per server tick; its changes go out with the edit deltas
+    std::vector<std::unique_ptr<Client>> clients_;
+    uint32_t tick_ = 0;
+    std::unique_ptr<Autosaver> autosaver_;
+
+    // per-tick scratch, kept so a steady tick loop reuses their capacity instead of allocating
+    std::vector<Message> messages_;
+    std::vector<BlockDelta> deltas_, batch_;
+    std::vector<ChunkCoord> dirtyScratch_;
+
+    // stats since the last report
+    uint64_t bytesOut_ = 0, bytesIn_ = 0;
+    uint64_t ticksMeasured_ = 0, editsApplied_ = 0, simChanges_ = 0;
+    double tickMsTotal_ = 0.0, tickMsMax_ = 0.0;
+};
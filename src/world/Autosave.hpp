@@ -0,0 +1,44 @@
+#pragma once
+#include "World.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr double AUTOSAVE_INTERVAL_SECONDS = 30.0;
+
+// Writes chunk snapshots to <dir>/<x>_<y>_<z>.chunk on a background thread.
+// The caller hands over World::snapshotUnsaved(), which shares cell storage with the live chunks, so the
+// main thread only pays for the refcount bumps; edits made while a save is in flight clone the touched chunk.
+class Autosaver {
+public:
+    explicit Autosaver(std::string dir); // creates dir if needed
+    ~Autosaver(); // finishes every submitted snapshot before returning
+
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+
+    void submit(std::vector<std::pair<ChunkCoord, Chunk>> snapshot);
+    uint64_t chunksWritten() const { return chunksWritten_; }
+    uint64_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    void workerLoop();
+    bool writeChunk(const ChunkCoord& coord, const Chunk& chunk);
+
+    std::string dir_;
+    std::mutex mutex_; // guards queue_ and stop_
+    std::condition_variable cv_;
+    std::vector<std::pair<ChunkCoord, Chunk>> queue_;
+    bool stop_ = false;
+    std::atomic<uint64_t> chunksWritten_{0}, bytesWritten_{0};
+    std::vector<uint8_t> encodeBuf_; // worker thread only; reused for every chunk file
+    std::thread thread_;
+};
+
+// Overlays every chunk found in dir onto world (see World::loadChunk). Returns the number of chunks loaded.
+size_t loadSavedChunks(const std::string& dir, World& world);
@@ -1,10 +1,18 @@
 #pragma once
+#include <cstdint>
 #include <glm/vec3.hpp>
 
-enum class BlockId {
+enum class BlockId : uint8_t { // what each id means is defined in BlockRegistry.hpp
     Tile,
     Turf,
-    Cardboard
+    Cardboard,
+    Sand,
+    Gravel,
+    Water, // fluid source
+    Lava, // fluid source
+    WaterFlow = 0x20, // WaterFlow + level: flowing water, level = distance from the source
+    LavaFlow = 0x30, // LavaFlow + level
+    Air = 0xFF // empty cell
 };
 
 struct Block {
@@ -12,8 +20,14 @@ struct Block {
     BlockId id;
 };
 
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction; // distances are measured in units of |direction|
+    float maxDistance;
+};
+
 struct BlockHitInfo {
-    int blockIndex; // Index in blocks vector
+    bool hit; // false if nothing was hit within maxDistance
     glm::ivec3 blockPos; // Position of the block
     int faceIndex; // Face index (0=bottom, 1=right, 2=top, 3=left, 4=front, 5=back)
     glm::ivec3 hitPos; // World position of intersection
@@ -0,0 +1,162 @@
+#pragma once
+#include "Block.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Every block type is one row of kBlockDefs. At compile time the rows are flattened into per-id tables
+// (kBlocks), so hot loops read a property with one indexed load instead of switching on the id.
+// Adding a block = a BlockId value, a row here and, if it needs one, a texture in kBlockTextureFiles.
+
+enum class TickBehaviour : uint8_t {
+    None,
+    Falls, // drops into any non-solid cell below
+    Fluid, // flows down, then sideways up to its reach; flowing cells use ids flowing + 1..reach
+};
+
+enum BlockFace : uint8_t { FaceFront, FaceRight, FaceBack, FaceLeft, FaceTop, FaceBottom }; // CubeMesh order: vertex v is on face v / 4
+
+// Layers of the block texture array, in load order
+inline constexpr const char* kBlockTextureFiles[] = {
+    "assets/tile.png", "assets/turf.png", "assets/cardboard.png", "assets/sand.png",
+    "assets/gravel.png", "assets/water.png", "assets/lava.png",
+};
+inline constexpr const char* kBlockTexturePack = "assets/blocks.tcpack"; // baked from the files above, see TexturePack.hpp
+enum TextureLayer : uint8_t { TexTile, TexTurf, TexCardboard, TexSand, TexGravel, TexWater, TexLava };
+
+struct BlockDef {
+    BlockId id;
+    const char* name;
+    bool opaque; // hides faces of neighbouring blocks
+    bool solid; // blocks movement; falling blocks and entities stop on it
+    bool replaceable; // placing a block overwrites it instead of being refused
+    uint8_t light; // emission, 0..15
+    std::array<uint8_t, 6> faces; // texture layer per BlockFace
+    TickBehaviour tick;
+    uint8_t tickDelay; // ticks from a wake-up to the update
+    uint8_t fluidReach; // Fluid: number of flowing levels
+    BlockId flowing; // Fluid: flowing cells are flowing + level
+    bool hotbar; // selectable with the number keys, in table order
+};
+
+constexpr std::array<uint8_t, 6> allFaces(uint8_t layer) { return {layer, layer, layer, layer, layer, layer}; }
+
+inline constexpr BlockDef kBlockDefs[] = {
+    // id                name         opaque solid  repl.  light faces
+    {BlockId::Tile,      "tile",      true,  true,  false, 0,  allFaces(TexTile),      TickBehaviour::None,  0,  0, BlockId::Air,       true},
+    {BlockId::Turf,      "turf",      true,  true,  false, 0,  {TexTurf, TexTurf, TexTurf, TexTurf, TexTurf, TexTile},
+                                                                                       TickBehaviour::None,  0,  0, BlockId::Air,       true},
+    {BlockId::Cardboard, "cardboard", true,  true,  false, 0,  allFaces(TexCardboard), TickBehaviour::None,  0,  0, BlockId::Air,       true},
+    {BlockId::Sand,      "sand",      true,  true,  false, 0,  allFaces(TexSand),      TickBehaviour::Falls, 2,  0, BlockId::Air,       true},
+    {BlockId::Gravel,    "gravel",    true,  true,  false, 0,  allFaces(TexGravel),    TickBehaviour::Falls, 2,  0, BlockId::Air,       true},
+    {BlockId::Water,     "water",     false, false, true,  0,  allFaces(TexWater),     TickBehaviour::Fluid, 5,  7, BlockId::WaterFlow, true},
+    {BlockId::Lava,      "lava",      false, false, true,  15, allFaces(TexLava),      TickBehaviour::Fluid, 15, 3, BlockId::LavaFlow,  true},
+};
+
+struct BlockTables { // indexed by uint8_t(BlockId); ids without a row (Air, unused values) read as empty space
+    std::array<bool, 256> registered{}; // has a row (or is a flowing level of one); Air and unused values don't
+    std::array<const char*, 256> name{};
+    std::array<bool, 256> opaque{};
+    std::array<bool, 256> solid{};
+    std::array<bool, 256> replaceable{};
+    std::array<uint8_t, 256> light{};
+    std::array<uint32_t, 256> faceLayers{}; // layer of BlockFace f in bits 5f..5f+4, decoded by the block shader
+    std::array<TickBehaviour, 256> tick{};
+    std::array<uint8_t, 256> tickDelay{};
+    std::array<BlockId, 256> fluidSource{}; // Air unless a fluid
+    std::array<uint8_t, 256> fluidLevel{}; // 0 = source
+    std::array<uint8_t, 256> fluidReach{};
+    std::array<uint8_t, 256> flowingBase{}; // flowing level L of this fluid is id flowingBase + L
+};
+
+consteval BlockTables buildBlockTables() {
+    BlockTables t;
+    t.fluidSource.fill(BlockId::Air);
+    t.name.fill("unknown");
+    t.name[uint8_t(BlockId::Air)] = "air";
+    t.replaceable[uint8_t(BlockId::Air)] = true;
+    auto setRow = [&t](const BlockDef& d, uint8_t id) {
+        t.registered[id] = true;
+        t.name[id] = d.name;
+        t.opaque[id] = d.opaque;
+        t.solid[id] = d.solid;
+        t.replaceable[id] = d.replaceable;
+        t.light[id] = d.light;
+        t.tick[id] = d.tick;
+        t.tickDelay[id] = d.tickDelay;
+        uint32_t packed = 0;
+        for (int f = 0; f < 6; ++f) packed |= uint32_t(d.faces[f] & 31) << (5 * f);
+        t.faceLayers[id] = packed;
+    };
+    for (const BlockDef& d : kBlockDefs) {
+        setRow(d, uint8_t(d.id));
+        if (d.tick != TickBehaviour::Fluid) continue;
+        t.fluidSource[uint8_t(d.id)] = d.id;
+        t.fluidReach[uint8_t(d.id)] = d.fluidReach;
+        t.flowingBase[uint8_t(d.id)] = uint8_t(d.flowing);
+        for (int level = 1; level <= d.fluidReach; ++level) { // flowing cells behave and look like their source
+            const uint8_t id = uint8_t(uint8_t(d.flowing) + level);
+            setRow(d, id);
+            t.fluidSource[id] = d.id;
+            t.fluidLevel[id] = uint8_t(level);
+            t.fluidReach[id] = d.fluidReach;
+            t.flowingBase[id] = uint8_t(d.flowing);
+        }
+    }
+    return t;
+}
+
+// buildBlockTables() writes flowing levels over whatever row shares their id, so each fluid's ids flowing + 1..reach
+// must fit in a byte and be claimed by nothing else: not Air, not a kBlockDefs row, not another fluid's levels
+consteval bool flowingIdsAreFree() {
+    std::array<bool, 256> taken{};
+    taken[uint8_t(BlockId::Air)] = true;
+    for (const BlockDef& d : kBlockDefs) taken[uint8_t(d.id)] = true;
+    for (const BlockDef& d : kBlockDefs) {
+        if (d.tick != TickBehaviour::Fluid) continue;
+        for (int level = 1; level <= d.fluidReach; ++level) {
+            const int id = int(uint8_t(d.flowing)) + level;
+            if (id > 255 || taken[id]) return false;
+            taken[id] = true;
+        }
+    }
+    return true;
+}
+static_assert(flowingIdsAreFree(), "a fluid's flowing ids overlap another block or fluid; move its flowing base");
+
+inline constexpr BlockTables kBlocks = buildBlockTables();
+
+static_assert(std::size(kBlockTextureFiles) <= 32, "face layers are packed in 5 bits");
+static_assert(!kBlocks.solid[uint8_t(BlockId::Air)] && !kBlocks.opaque[uint8_t(BlockId::Air)]);
+
+// Ids from outside the program (scripts, the network) must pass this before they reach a world
+constexpr bool isRegistered(BlockId id) { return kBlocks.registered[uint8_t(id)]; }
+constexpr const char* blockName(BlockId id) { return kBlocks.name[uint8_t(id)]; }
+constexpr bool isOpaque(BlockId id) { return kBlocks.opaque[uint8_t(id)]; }
+constexpr bool isSolid(BlockId id) { return kBlocks.solid[uint8_t(id)]; }
+constexpr bool isReplaceable(BlockId id) { return kBlocks.replaceable[uint8_t(id)]; } // Air, fluids
+constexpr uint8_t lightEmission(BlockId id) { return kBlocks.light[uint8_t(id)]; }
+constexpr uint32_t faceLayers(BlockId id) { return kBlocks.faceLayers[uint8_t(id)]; }
+constexpr TickBehaviour tickBehaviour(BlockId id) { return kBlocks.tick[uint8_t(id)]; }
+constexpr uint32_t tickDelay(BlockId id) { return kBlocks.tickDelay[uint8_t(id)]; } // 0 = never ticks
+
+// Flowing fluids carry their distance from the source in the id, so chunks, saves and the wire need no extra state
+constexpr BlockId fluidSource(BlockId id) { return kBlocks.fluidSource[uint8_t(id)]; } // Air for non-fluids
+constexpr bool isFluid(BlockId id) { return fluidSource(id) != BlockId::Air; }
+constexpr int fluidLevel(BlockId id) { return kBlocks.fluidLevel[uint8_t(id)]; } // 0 = source
+constexpr int maxFluidLevel(BlockId id) { return kBlocks.fluidReach[uint8_t(id)]; }
+constexpr BlockId flowingFluid(BlockId source, int level) { return BlockId(kBlocks.flowingBase[uint8_t(source)] + level); }
+// What a player may put into the world: a row of kBlockDefs; flowing levels only come from the ticker
+constexpr bool isPlaceable(BlockId id) { return isRegistered(id) && fluidLevel(id) == 0; }
+
+consteval size_t hotbarSize() {
+    size_t n = 0;
+    for (const BlockDef& d : kBlockDefs) n += d.hotbar;
+    return n;
+}
+inline constexpr std::array<BlockId, hotbarSize()> kHotbar = [] { // number key k holds kHotbar[k - 1]
+    std::array<BlockId, hotbarSize()> out{};
+    size_t n = 0;
+    for (const BlockDef& d : kBlockDefs) if (d.hotbar) out[n++] = d.id;
+    return out;
+}();
@@ -0,0 +1,211 @@
+#include "BlockTicker.hpp"
+#include "BlockRegistry.hpp"
+#include <algorithm>
+#include <barrier>
+#include <thread>
+
+static const glm::ivec3 kNeighbours[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0} }; // sides first
+static const glm::ivec3 kUp(0, 1, 0);
+
+static int phaseOf(const ChunkCoord& c) { return (c.x & 1) | ((c.y & 1) << 1) | ((c.z & 1) << 2); }
+
+BlockTicker::BlockTicker(World& world) : world_(world) {}
+
+void BlockTicker::schedule(const glm::ivec3& pos, BlockId id, uint32_t from) {
+    const uint32_t delay = tickDelay(id);
+    if (delay == 0) return;
+    const glm::ivec3 local = localOf(pos);
+    active_[chunkOf(pos)].push_back(Scheduled{uint16_t(Chunk::index(local.x, local.y, local.z)), from + delay});
+}
+
+void BlockTicker::wake(const glm::ivec3& pos) {
+    schedule(pos, world_.get(pos), tick_);
+    for (const glm::ivec3& n : kNeighbours) schedule(pos + n, world_.get(pos + n), tick_);
+}
+
+void BlockTicker::wakeChunk(const ChunkCoord& coord) {
+    const Chunk* chunk = world_.chunk(coord);
+    if (!chunk || chunk->empty()) return;
+    const Chunk::Cells& cells = chunk->cells();
+    for (int i = 0; i < CHUNK_VOLUME; ++i) {
+        if (uint32_t delay = tickDelay(cells[i])) active_[coord].push_back(Scheduled{uint16_t(i), tick_ + delay});
+    }
+}
+
+size_t BlockTicker::activeCells() const {
+    size_t count = 0;
+    for (const auto& [coord, cells] : active_) count += cells.size();
+    return count;
+}
+
+void BlockTicker::tick() {
+    changes_.clear();
+    collectDue();
+    runPhases();
+    ++tick_;
+}
+
+// Moves every due cell out of active_ into dueCells_, one sorted, de-duplicated range per chunk
+void BlockTicker::collectDue() {
+    dueCells_.clear();
+    for (std::vector<Job>& jobs : phases_) jobs.clear();
+    for (auto it = active_.begin(); it != active_.end();) {
+        std::vector<Scheduled>& pending = it->second;
+        Chunk* chunk = world_.chunkForWrite(it->first); // null if the chunk has been unloaded since
+        const size_t begin = dueCells_.size();
+        for (const Scheduled& s : pending) {
+            if (chunk && s.due <= tick_) dueCells_.push_back(s.cell);
+        }
+        std::erase_if(pending, [&](const Scheduled& s) { return !chunk || s.due <= tick_; });
+        if (dueCells_.size() > begin) {
+            std::sort(dueCells_.begin() + begin, dueCells_.end());
+            dueCells_.erase(std::unique(dueCells_.begin() + begin, dueCells_.end()), dueCells_.end());
+            phases_[phaseOf(it->first)].push_back(Job{it->first, chunk, begin, dueCells_.size()});
+        }
+        if (pending.empty()) it = active_.erase(it);
+        else ++it;
+    }
+}
+
+// Threads are started once per tick, not per phase, and only when there are enough due cells to pay for them.
+// They meet at a barrier after each phase, whose completion step merges the phase on one thread.
+void BlockTicker::runPhases() {
+    if (dueCells_.empty()) return;
+    constexpr size_t CELLS_PER_THREAD = 1024; // a thread start costs about as much as updating a few hundred cells
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::clamp<size_t>(dueCells_.size() / CELLS_PER_THREAD, 1, hw);
+    if (workers_.size() < workers) workers_.resize(workers);
+    if (workers == 1) {
+        for (const std::vector<Job>& jobs : phases_) {
+            runJobs(jobs, 0, 1);
+            mergeWorkers(1);
+        }
+        return;
+    }
+    std::barrier phaseDone(std::ptrdiff_t(workers), [this, workers]() noexcept { mergeWorkers(workers); });
+    auto work = [&](size_t w) {
+        for (const std::vector<Job>& jobs : phases_) {
+            runJobs(jobs, w, workers);
+            phaseDone.arrive_and_wait();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) threads.emplace_back(work, w);
+    work(0);
+    for (std::thread& t : threads) t.join();
+}
+
+// Worker w's share of one phase's chunks
+void BlockTicker::runJobs(const std::vector<Job>& jobs, size_t w, size_t workers) {
+    for (size_t j = jobs.size() * w / workers; j < jobs.size() * (w + 1) / workers; ++j) {
+        const Job& job = jobs[j];
+        const glm::ivec3 origin = chunkOrigin(job.coord);
+        for (size_t i = job.begin; i < job.end; ++i) {
+            const int cell = dueCells_[i];
+            update(workers_[w], job, origin + glm::ivec3(cell % CHUNK_SIZE, cell / (CHUNK_SIZE * CHUNK_SIZE), (cell / CHUNK_SIZE) % CHUNK_SIZE));
+        }
+    }
+}
+
+// Single-threaded between phases: publish edits, apply the queued cross-chunk moves and merge the new wake-ups.
+// Workers are merged in order and a cell only ever has one writer per phase, so the result doesn't depend on how
+// many threads ran.
+void BlockTicker::mergeWorkers(size_t workers) {
+    for (size_t w = 0; w < workers; ++w) {
+        Worker& worker = workers_[w];
+        for (const ChunkCoord& coord : worker.edited) world_.markEdited(coord);
+        changes_.insert(changes_.end(), worker.changes.begin(), worker.changes.end());
+        for (const auto& [pos, due] : worker.wakes) {
+            const glm::ivec3 local = localOf(pos);
+            active_[chunkOf(pos)].push_back(Scheduled{uint16_t(Chunk::index(local.x, local.y, local.z)), due});
+        }
+        for (const Block& b : worker.crossChunk) {
+            world_.add(b); // may create the chunk
+            changes_.push_back(b);
+            schedule(b.pos, b.id, tick_);
+            for (const glm::ivec3& n : kNeighbours) schedule(b.pos + n, world_.get(b.pos + n), tick_);
+        }
+        worker.edited.clear();
+        worker.changes.clear();
+        worker.wakes.clear();
+        worker.crossChunk.clear();
+    }
+}
+
+BlockId BlockTicker::get(const Job& job, const glm::ivec3& pos) const {
+    if (chunkOf(pos) == job.coord) return job.chunk->get(pos - chunkOrigin(job.coord));
+    return world_.get(pos); // a neighbour chunk: no one writes it during this phase
+}
+
+void BlockTicker::set(Worker& w, const Job& job, const glm::ivec3& pos, BlockId id) {
+    if (get(job, pos) == id) return;
+    if (!(chunkOf(pos) == job.coord)) {
+        w.crossChunk.push_back(Block{pos, id});
+        return;
+    }
+    job.chunk->set(pos - chunkOrigin(job.coord), id);
+    if (w.edited.empty() || !(w.edited.back() == job.coord)) w.edited.push_back(job.coord);
+    w.changes.push_back(Block{pos, id});
+    auto wakeCell = [&](const glm::ivec3& p) {
+        if (uint32_t delay = tickDelay(get(job, p))) w.wakes.emplace_back(p, tick_ + delay);
+    };
+    wakeCell(pos);
+    for (const glm::ivec3& n : kNeighbours) wakeCell(pos + n);
+}
+
+void BlockTicker::update(Worker& w, const Job& job, const glm::ivec3& pos) {
+    const BlockId id = get(job, pos);
+    const glm::ivec3 below = pos - kUp;
+
+    const TickBehaviour behaviour = tickBehaviour(id);
+    if (behaviour == TickBehaviour::Falls) {
+        if (pos.y <= VOID_Y) {
+            set(w, job, pos, BlockId::Air); // fell out of the world
+            return;
+        }
+        const BlockId under = get(job, below);
+        if (!isSolid(under)) { // sinks through fluid, displacing it
+            set(w, job, below, id);
+            set(w, job, pos, BlockId::Air);
+        }
+        return;
+    }
+    if (behaviour != TickBehaviour::Fluid) return; // replaced since it was scheduled
+
+    const BlockId source = fluidSource(id);
+    const int level = fluidLevel(id);
+    if (source == BlockId::Lava) {
+        for (const glm::ivec3& n : kNeighbours) {
+            if (fluidSource(get(job, pos + n)) == BlockId::Water) {
+                set(w, job, pos, level == 0 ? BlockId::Tile : BlockId::Gravel); // lava meets water: it hardens
+                return;
+            }
+        }
+    }
+    if (level > 0) { // flowing: needs fluid above or a side neighbour closer to the source
+        bool fed = fluidSource(get(job, pos + kUp)) == source;
+        for (int i = 0; i < 4 && !fed; ++i) {
+            const BlockId n = get(job, pos + kNeighbours[i]);
+            fed = fluidSource(n) == source && fluidLevel(n) < level;
+        }
+        if (!fed) {
+            set(w, job, pos, BlockId::Air);
+            return;
+        }
+    }
+
+    // Fall first; only fluid resting on something solid spreads sideways
+    const BlockId under = (below.y < VOID_Y) ? BlockId::Tile : get(job, below);
+    if (under == BlockId::Air || (fluidSource(under) == source && fluidLevel(under) > 1)) {
+        set(w, job, below, flowingFluid(source, 1));
+        return;
+    }
+    if (isFluid(under) || level == maxFluidLevel(id)) return;
+    const BlockId next = flowingFluid(source, level + 1);
+    for (int i = 0; i < 4; ++i) {
+        const glm::ivec3 side = pos + kNeighbours[i];
+        const BlockId n = get(job, side);
+        if (n == BlockId::Air || (fluidSource(n) == source && fluidLevel(n) > level + 1)) set(w, job, side, next);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "World.hpp"
+#include "../mem/Pool.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Scheduled block updates, driven by each block's TickBehaviour in BlockRegistry: falling blocks drop, fluids
+// spread out from their sources and dry up without one, lava next to water hardens. Only cells that were woken
+// (by an edit or a neighbour changing) are looked at, so a tick costs O(active cells) however big the world is.
+// Chunks run in eight checkerboard phases by the parity of their coordinates. Chunks of one phase are never
+// neighbours, so each worker writes its own chunk directly and reads its neighbours while nobody writes them;
+// moves across a chunk face are queued and applied between phases. Changed chunks go through World's normal
+// dirty/unsaved tracking, so they are remeshed and autosaved like any edit.
+class BlockTicker {
+public:
+    explicit BlockTicker(World& world);
+
+    void wake(const glm::ivec3& pos); // after an edit: schedule pos and its six neighbours
+    void wakeChunk(const ChunkCoord& coord); // schedule every tickable cell, e.g. of a chunk loaded from a save
+    void tick();
+
+    const std::vector<Block>& changes() const { return changes_; } // cells the last tick() changed, in order
+    size_t activeCells() const; // scheduled cells, due or not
+    uint32_t tickCount() const { return tick_; }
+
+    static constexpr int TICK_RATE = 20; // ticks per second
+    static constexpr int VOID_Y = -64; // falling blocks vanish here and fluids stop spreading down
+
+private:
+    struct Scheduled { uint16_t cell; uint32_t due; }; // cell = Chunk::index inside its chunk
+    struct Job { ChunkCoord coord; Chunk* chunk; size_t begin, end; }; // one chunk's due cells in dueCells_
+    struct Worker { // one thread's output, merged after each phase; kept between ticks to reuse capacity
+        std::vector<Block> changes;
+        std::vector<Block> crossChunk; // writes into other chunks, applied after the phase
+        std::vector<std::pair<glm::ivec3, uint32_t>> wakes; // (cell, due tick)
+        std::vector<ChunkCoord> edited;
+    };
+
+    void collectDue();
+    void runPhases();
+    void runJobs(const std::vector<Job>& jobs, size_t w, size_t workers);
+    void mergeWorkers(size_t workers);
+    void update(Worker& w, const Job& job, const glm::ivec3& pos);
+    BlockId get(const Job& job, const glm::ivec3& pos) const;
+    void set(Worker& w, const Job& job, const glm::ivec3& pos, BlockId id);
+    void schedule(const glm::ivec3& pos, BlockId id, uint32_t from);
+
+    World& world_;
+    std::unordered_map<ChunkCoord, std::vector<Scheduled>, ChunkCoordHash, std::equal_to<ChunkCoord>,
+                       PoolAllocator<std::pair<const ChunkCoord, std::vector<Scheduled>>>> active_;
+    uint32_t tick_ = 0;
+    std::vector<uint16_t> dueCells_;
+    std::array<std::vector<Job>, 8> phases_;
+    std::vector<Worker> workers_;
+    std::vector<Block> changes_;
+};
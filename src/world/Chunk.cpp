@@ -0,0 +1,56 @@
+#include "Chunk.hpp"
+#include "../mem/Pool.hpp"
+#include "../mem/Stats.hpp"
+#include <atomic>
+
+static ResourceStat gCellArrays("world.chunk_cells", StatUnit::Count); // live cell arrays, copy-on-write clones included
+
+// PoolAllocator that also counts cell arrays; allocate_shared rebinds it to the combined cells + control block
+template <typename T> struct CellsAllocator : PoolAllocator<T> {
+    CellsAllocator() = default;
+    template <typename U> CellsAllocator(const CellsAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        gCellArrays.add(int64_t(n));
+        return PoolAllocator<T>::allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        gCellArrays.sub(int64_t(n));
+        PoolAllocator<T>::deallocate(p, n);
+    }
+};
+
+// Cells and their shared_ptr control block come from one fixed-size pool, so streaming chunks in and out (and
+// copy-on-write clones) recycle the same 4 KiB blocks instead of going through the general heap.
+Chunk::Chunk() : cells_(std::allocate_shared<Cells>(CellsAllocator<Cells>())) {
+    cells_->fill(BlockId::Air);
+}
+
+void Chunk::detach() {
+    if (cells_.use_count() == 1) {
+        // A snapshot holder may have just released its reference on another thread; pair with that release
+        // so its reads of the old contents happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return;
+    }
+    cells_ = std::allocate_shared<Cells>(CellsAllocator<Cells>(), *cells_);
+}
+
+void Chunk::set(const glm::ivec3& local, BlockId id) {
+    const int i = index(local.x, local.y, local.z);
+    if ((*cells_)[i] == id) return;
+    detach();
+    BlockId& cell = (*cells_)[i];
+    nonAirCount_ += int(id != BlockId::Air) - int(cell != BlockId::Air);
+    cell = id;
+}
+
+Chunk::Cells& Chunk::cells() {
+    detach();
+    return *cells_;
+}
+
+void Chunk::recount() {
+    nonAirCount_ = 0;
+    for (BlockId id : *cells_) nonAirCount_ += int(id != BlockId::Air);
+}
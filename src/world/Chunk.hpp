@@ -0,0 +1,63 @@
+#pragma once
+#include "Block.hpp"
+#include <glm/vec3.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+constexpr int CHUNK_SIZE = 16; // blocks per axis
+constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+struct ChunkCoord { // chunk-space position (world position / CHUNK_SIZE, rounded down)
+    int x, y, z;
+    bool operator==(const ChunkCoord&) const = default;
+};
+
+struct ChunkCoordHash {
+    size_t operator()(const ChunkCoord& c) const {
+        return std::hash<long long>()(((long long)c.x * 73856093) ^ ((long long)c.y * 19349663) ^ ((long long)c.z * 83492791));
+    }
+};
+
+inline int floorDiv(int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+
+inline ChunkCoord chunkOf(const glm::ivec3& pos) {
+    return ChunkCoord{floorDiv(pos.x, CHUNK_SIZE), floorDiv(pos.y, CHUNK_SIZE), floorDiv(pos.z, CHUNK_SIZE)};
+}
+
+inline glm::ivec3 chunkOrigin(const ChunkCoord& c) { // world position of local (0,0,0)
+    return glm::ivec3(c.x, c.y, c.z) * CHUNK_SIZE;
+}
+
+inline glm::ivec3 localOf(const glm::ivec3& pos) { // position inside its chunk, each axis in [0, CHUNK_SIZE)
+    return pos - chunkOrigin(chunkOf(pos));
+}
+
+// Dense CHUNK_SIZE^3 grid of block ids, Air where empty.
+// Copies share their cell storage (reference counted); the first write through a shared copy clones it, so
+// snapshotting a chunk for a background reader costs one refcount bump instead of a 4 KiB copy.
+class Chunk {
+public:
+    using Cells = std::array<BlockId, CHUNK_VOLUME>;
+
+    Chunk();
+
+    static int index(int x, int y, int z) { return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x; }
+    BlockId get(int x, int y, int z) const { return (*cells_)[index(x, y, z)]; }
+    BlockId get(const glm::ivec3& local) const { return get(local.x, local.y, local.z); }
+    void set(const glm::ivec3& local, BlockId id); // keeps nonAirCount() up to date
+
+    int nonAirCount() const { return nonAirCount_; } // fluids included: they mesh and tick even though they are not solid
+    bool empty() const { return nonAirCount_ == 0; }
+    const Cells& cells() const { return *cells_; }
+    Cells& cells(); // raw write access (detaches a shared copy); call recount() after bulk writes
+    void recount();
+    bool sharesStorageWith(const Chunk& other) const { return cells_ == other.cells_; }
+
+private:
+    void detach(); // make cells_ exclusively ours before writing
+
+    std::shared_ptr<Cells> cells_;
+    int nonAirCount_ = 0;
+};
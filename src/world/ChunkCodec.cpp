@@ -0,0 +1,27 @@
+#include "ChunkCodec.hpp"
+
+void encodeChunk(const Chunk& chunk, std::vector<uint8_t>& out) {
+    const auto& cells = chunk.cells();
+    int i = 0;
+    while (i < CHUNK_VOLUME) {
+        BlockId id = cells[i];
+        int run = 1;
+        while (i + run < CHUNK_VOLUME && run < 256 && cells[i + run] == id) ++run;
+        out.push_back(uint8_t(run - 1));
+        out.push_back(uint8_t(id));
+        i += run;
+    }
+}
+
+bool decodeChunk(const uint8_t* data, size_t size, Chunk& chunk) {
+    if (size % 2 != 0) return false;
+    auto& cells = chunk.cells();
+    int i = 0;
+    for (size_t p = 0; p < size; p += 2) {
+        int run = int(data[p]) + 1;
+        if (i + run > CHUNK_VOLUME) return false;
+        for (int k = 0; k < run; ++k) cells[i++] = static_cast<BlockId>(data[p + 1]);
+    }
+    chunk.recount();
+    return i == CHUNK_VOLUME;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "Chunk.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Run-length encoding of a chunk's cells as (run length - 1, block id) byte pairs.
+// Terrain is mostly long runs of air or one material, so a typical chunk shrinks from 4 KiB to a few dozen bytes.
+void encodeChunk(const Chunk& chunk, std::vector<uint8_t>& out); // appends to out
+bool decodeChunk(const uint8_t* data, size_t size, Chunk& chunk); // false on malformed input
@@ -1,19 +1,21 @@
-#include <vector>
+#include <random>
 #include <glm/vec3.hpp>
 #include "Block.hpp"
 #include "TerrainGen.hpp"
 
-std::vector<Block> makeTerrain(int terrainWidth, int terrainHeight) {
-    std::vector<Block> blocks;
+World makeTerrain(int terrainWidth, int terrainHeight, uint32_t seed) {
+    World world;
+    std::mt19937 rng(seed); // same sequence on every platform, unlike rand()
     for (int x = -terrainWidth / 2; x < terrainWidth / 2; ++x) {
         for (int z = -terrainWidth / 2; z < terrainWidth / 2; ++z) {
             for (int y = 0; y < terrainHeight; ++y) {
                 int blockId = (y >= terrainHeight - 2) ? 1 : 0; // turf on top layer, tile below
-                if (y < terrainHeight - 1 || (rand() % 10) < 4) {
-                    blocks.push_back(Block{glm::vec3(float(x), float(y), float(z)), static_cast<BlockId>(blockId)});
+                if (y < terrainHeight - 1 || (rng() % 10) < 4) {
+                    world.add(Block{glm::vec3(float(x), float(y), float(z)), static_cast<BlockId>(blockId)});
                 }
             }
         }
     }
-    return blocks;
+    world.discardUnsaved(); // generated terrain is reproducible from its seed, only edits need saving
+    return world;
 }
\ No newline at end of file
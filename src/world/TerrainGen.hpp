@@ -1,6 +1,9 @@
 #pragma once
-#include <vector>
+#include <cstdint>
 #include <glm/vec3.hpp>
 #include "Block.hpp"
+#include "World.hpp"
 
-std::vector<Block> makeTerrain(int terrainWidth, int terrainHeight);
\ No newline at end of file
+constexpr uint32_t kDefaultTerrainSeed = 1; // fixed so every run, benchmark and server sees the same world
+
+World makeTerrain(int terrainWidth, int terrainHeight, uint32_t seed); // written straight into chunk storage
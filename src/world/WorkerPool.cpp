@@ -0,0 +1,61 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t helpers) {
+    threads_.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i) threads_.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : threads_) t.join();
+}
+
+void WorkerPool::runTasks(size_t tasks, TaskFn call, void* fn) {
+    std::unique_lock<std::mutex> busy(runMutex_, std::try_to_lock);
+    if (!busy.owns_lock() || tasks <= 1 || threads_.empty()) {
+        for (size_t task = 0; task < tasks; ++task) call(fn, task);
+        return;
+    }
+    const size_t parallel = std::min(tasks, size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        call_ = call;
+        fn_ = fn;
+        tasks_ = parallel;
+        remaining_ = parallel - 1;
+        ++generation_;
+    }
+    wake_.notify_all();
+    call(fn, 0);
+    for (size_t task = parallel; task < tasks; ++task) call(fn, task); // more tasks than threads: the rest run here
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+// Thread `index` runs task `index` of every run that has that many tasks, and otherwise goes back to sleep
+void WorkerPool::workerLoop(size_t index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        if (index >= tasks_) continue;
+        const TaskFn call = call_;
+        void* fn = fn_;
+        lock.unlock();
+        call(fn, index);
+        lock.lock();
+        if (--remaining_ == 0) done_.notify_one();
+    }
+}
+
+WorkerPool& workerPool() {
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Threads that stay parked between parallel sections, so splitting a per-frame or per-step loop costs a wake-up
+// instead of a thread start. run(tasks, fn) calls fn(0) .. fn(tasks - 1) once each, fn(0) on the calling thread,
+// and returns when all of them have finished. A run() issued while another is in progress (from another thread,
+// or from inside a task) executes its tasks one after another on its caller instead of waiting for the pool.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t helpers); // threads besides the caller
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const { return threads_.size() + 1; } // tasks that can run at once, the caller included
+
+    template <typename Fn> void run(size_t tasks, Fn&& fn) { // tasks beyond size() run on the caller after fn(0)
+        runTasks(tasks, [](void* f, size_t task) { (*static_cast<std::remove_reference_t<Fn>*>(f))(task); }, &fn);
+    }
+
+private:
+    using TaskFn = void (*)(void* fn, size_t task);
+
+    void runTasks(size_t tasks, TaskFn call, void* fn);
+    void workerLoop(size_t index);
+
+    std::vector<std::thread> threads_;
+    std::mutex runMutex_; // held for a whole run()
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    TaskFn call_ = nullptr;
+    void* fn_ = nullptr;
+    size_t tasks_ = 0;
+    size_t remaining_ = 0; // helper tasks of the current run still going
+    uint64_t generation_ = 0; // bumped by every run() so parked threads know there is new work
+    bool stop_ = false;
+};
+
+WorkerPool& workerPool(); // shared by World and Entities; one thread per hardware thread, the caller's included
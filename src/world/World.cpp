@@ -1,81 +1,177 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <vector>
 #include "Block.hpp"
 #include "World.hpp"
+#include "WorkerPool.hpp"
 #include <glm/vec3.hpp>
 
-World::World(std::vector<Block> blocks) {
-    blocks_ = std::move(blocks);
+BlockId World::get(const glm::ivec3& pos) const {
+    auto it = chunks_.find(chunkOf(pos));
+    return (it == chunks_.end()) ? BlockId::Air : it->second.get(localOf(pos));
 }
 
-const std::vector<Block>& World::blocks() const {
-    return blocks_;
+const Chunk* World::chunk(const ChunkCoord& coord) const {
+    auto it = chunks_.find(coord);
+    return (it == chunks_.end()) ? nullptr : &it->second;
+}
+
+void World::replaceChunk(const ChunkCoord& coord, const Chunk& chunk) {
+    chunks_[coord] = chunk;
+    ++version_;
+}
+
+void World::loadChunk(const ChunkCoord& coord, const Chunk& chunk) {
+    chunks_[coord] = chunk;
+    markDirty(coord);
+}
+
+Chunk* World::chunkForWrite(const ChunkCoord& coord) {
+    auto it = chunks_.find(coord);
+    return (it == chunks_.end()) ? nullptr : &it->second;
+}
+
+void World::markEdited(const ChunkCoord& coord) {
+    markDirty(coord);
+    unsaved_.insert(coord);
+}
+
+size_t World::blockCount() const {
+    size_t count = 0;
+    for (const auto& [coord, chunk] : chunks_) count += chunk.nonAirCount();
+    return count;
+}
+
+void World::markDirty(const ChunkCoord& coord) {
+    ++version_;
+    if (std::find(dirty_.begin(), dirty_.end(), coord) == dirty_.end()) dirty_.push_back(coord);
+}
+
+void World::takeDirtyChunks(std::vector<ChunkCoord>& out) {
+    out.swap(dirty_); // both vectors keep their capacity, so steady-state editing never allocates here
+    dirty_.clear();
+}
+
+std::vector<std::pair<ChunkCoord, Chunk>> World::snapshotUnsaved() {
+    std::vector<std::pair<ChunkCoord, Chunk>> out;
+    out.reserve(unsaved_.size());
+    for (const ChunkCoord& coord : unsaved_) out.emplace_back(coord, chunks_.at(coord));
+    unsaved_.clear();
+    return out;
+}
+
+void World::discardUnsaved() {
+    unsaved_.clear();
 }
 
 BlockHitInfo World::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
-    BlockHitInfo bestHit{ -1, glm::vec3(0), -1, glm::vec3(0), maxDistance + 1.0f };
-
-    for (size_t i = 0; i < blocks_.size(); ++i) { // iterate over every block and check distance
-        const Block& block = blocks_[i]; // current block
-        glm::vec3 blockMin = glm::vec3(block.pos) - glm::vec3(0.5f); // most negative corner of the block
-        glm::vec3 blockMax = glm::vec3(block.pos) + glm::vec3(0.5f); // most positive corner of the block
-
-        float tMin = -INFINITY, tMax = INFINITY; // tMin: the minimum t value of the intersection, tMax: the maximum t value of the intersection
-        // t value: the distance along the ray where it intersects the block's slabs (parameterized line)
-
-        // X slab
-        if (direction.x != 0.0f) {
-            float tx1 = (blockMin.x - origin.x) / direction.x;
-            float tx2 = (blockMax.x - origin.x) / direction.x;
-            tMin = std::max(tMin, std::min(tx1, tx2));
-            tMax = std::min(tMax, std::max(tx1, tx2));
-        } else if (origin.x < blockMin.x || origin.x > blockMax.x) {
-            continue;
-        }
+    // A packet with a single lane: the scalar and batched queries share one traversal so they can never disagree
+    Ray ray{origin, direction, maxDistance};
+    BlockHitInfo hit;
+    raycastPacket(&ray, &hit, 1);
+    return hit;
+}
 
-        // Y slab
-        if (direction.y != 0.0f) {
-            float ty1 = (blockMin.y - origin.y) / direction.y;
-            float ty2 = (blockMax.y - origin.y) / direction.y;
-            tMin = std::max(tMin, std::min(ty1, ty2));
-            tMax = std::min(tMax, std::max(ty1, ty2));
-        } else if (origin.y < blockMin.y || origin.y > blockMax.y) {
-            continue;
+void World::raycastBatch(std::span<const Ray> rays, std::span<BlockHitInfo> hits) const {
+    if (rays.size() != hits.size()) throw std::invalid_argument("raycastBatch: rays and hits differ in size");
+    const size_t count = rays.size();
+    constexpr size_t RAYS_PER_THREAD = 2048; // below this, handing out slices costs more than it saves
+    const size_t workers = std::clamp<size_t>(count / RAYS_PER_THREAD, 1, workerPool().size());
+    // Split on packet boundaries; the calling thread takes the first slice
+    const size_t packets = (count + RAY_PACKET - 1) / RAY_PACKET;
+    workerPool().run(workers, [&](size_t w) {
+        const size_t end = std::min(count, (packets * (w + 1) / workers) * RAY_PACKET);
+        for (size_t i = std::min(count, (packets * w / workers) * RAY_PACKET); i < end; i += RAY_PACKET) {
+            raycastPacket(rays.data() + i, hits.data() + i, int(std::min<size_t>(RAY_PACKET, end - i)));
         }
+    });
+}
 
-        // Z slab
-        if (direction.z != 0.0f) {
-            float tz1 = (blockMin.z - origin.z) / direction.z;
-            float tz2 = (blockMax.z - origin.z) / direction.z;
-            tMin = std::max(tMin, std::min(tz1, tz2));
-            tMax = std::min(tMax, std::max(tz1, tz2));
-        } else if (origin.z < blockMin.z || origin.z > blockMax.z) {
-            continue;
-        }
+// Amanatides & Woo voxel traversal for up to RAY_PACKET rays in lockstep. Blocks are unit cubes centred on
+// integer positions, so cell = floor(p + 0.5). The cell containing the origin is never reported (a ray starting
+// inside a block sees the next one), matching the old per-block slab test.
+void World::raycastPacket(const Ray* rays, BlockHitInfo* hits, int count) const {
+    constexpr int N = RAY_PACKET;
+    alignas(32) int cell[3][N], step[3][N];
+    alignas(32) float tMax[3][N], tDelta[3][N], t[N], limit[N];
+    alignas(32) int axis[N];
+    bool active[N];
+    const Chunk* chunkPtr[N];
+    ChunkCoord chunkAt[N];
 
-        if (tMax < tMin || tMin < 0 || tMin > maxDistance) continue;
-
-        glm::vec3 intersection = origin + tMin * direction;
-        glm::vec3 offset = intersection - glm::vec3(block.pos);
-        int face = -1;
-        if (std::abs(offset.x) > std::abs(offset.y) && std::abs(offset.x) > std::abs(offset.z)) {
-            face = (offset.x > 0) ? 1 : 3; // right or left
-        } else if (std::abs(offset.y) > std::abs(offset.x) && std::abs(offset.y) > std::abs(offset.z)) {
-            face = (offset.y > 0) ? 2 : 0; // top or bottom
-        } else {
-            face = (offset.z > 0) ? 4 : 5; // front or back
+    for (int i = 0; i < N; ++i) {
+        const bool used = i < count;
+        const Ray& r = rays[used ? i : 0]; // unused lanes shadow lane 0 but start inactive
+        if (used) hits[i] = BlockHitInfo{false, glm::ivec3(0), -1, glm::ivec3(0), r.maxDistance + 1.0f};
+        for (int a = 0; a < 3; ++a) {
+            const float o = r.origin[a] + 0.5f;
+            const float d = r.direction[a];
+            const float c = std::floor(o);
+            cell[a][i] = int(c);
+            step[a][i] = (d > 0.0f) ? 1 : (d < 0.0f) ? -1 : 0;
+            tDelta[a][i] = (d != 0.0f) ? std::abs(1.0f / d) : INFINITY;
+            tMax[a][i] = (d > 0.0f) ? (c + 1.0f - o) / d : (d < 0.0f) ? (o - c) / -d : INFINITY;
         }
+        limit[i] = r.maxDistance;
+        active[i] = used;
+        chunkAt[i] = chunkOf(glm::ivec3(cell[0][i], cell[1][i], cell[2][i]));
+        chunkPtr[i] = chunk(chunkAt[i]);
+    }
 
-        if (tMin < bestHit.distance) {
-            bestHit = { int(i), glm::vec3(block.pos), face, intersection, tMin };
+    for (bool any = count > 0; any;) {
+        // Step every lane into its next cell: pick the axis whose boundary is nearest, branch-free
+        for (int i = 0; i < N; ++i) {
+            const float tx = tMax[0][i], ty = tMax[1][i], tz = tMax[2][i];
+            const bool sx = tx <= ty && tx <= tz;
+            const bool sy = !sx && ty <= tz;
+            const bool sz = !sx && !sy;
+            t[i] = sx ? tx : (sy ? ty : tz);
+            axis[i] = sx ? 0 : (sy ? 1 : 2);
+            cell[0][i] += sx ? step[0][i] : 0;
+            cell[1][i] += sy ? step[1][i] : 0;
+            cell[2][i] += sz ? step[2][i] : 0;
+            tMax[0][i] += sx ? tDelta[0][i] : 0.0f;
+            tMax[1][i] += sy ? tDelta[1][i] : 0.0f;
+            tMax[2][i] += sz ? tDelta[2][i] : 0.0f;
+        }
+        // Voxel lookups are gathers; do them per lane, re-resolving the chunk only when a lane leaves it
+        any = false;
+        for (int i = 0; i < N; ++i) {
+            if (!active[i]) continue;
+            if (!(t[i] <= limit[i])) { active[i] = false; continue; }
+            const glm::ivec3 pos(cell[0][i], cell[1][i], cell[2][i]);
+            const ChunkCoord cc = chunkOf(pos);
+            if (!(cc == chunkAt[i])) {
+                chunkAt[i] = cc;
+                chunkPtr[i] = chunk(cc);
+            }
+            if (chunkPtr[i] && chunkPtr[i]->get(pos - chunkOrigin(cc)) != BlockId::Air) {
+                // Entered through the face opposite to the step direction
+                static constexpr int kEntryFace[3][2] = { {1, 3}, {2, 0}, {4, 5} }; // [axis][stepped +]
+                const int a = axis[i];
+                const Ray& r = rays[i];
+                glm::vec3 intersection = r.origin + t[i] * r.direction;
+                hits[i] = BlockHitInfo{true, pos, kEntryFace[a][step[a][i] > 0], intersection, t[i]};
+                active[i] = false;
+                continue;
+            }
+            any = true;
         }
     }
-    return bestHit;
 }
 
 void World::add(const Block& block) {
-    blocks_.push_back(block);
+    set(block.pos, block.id);
 }
 
 void World::remove(const glm::ivec3& pos) {
-    blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(), [&pos](const Block& block) { return block.pos == pos; }), blocks_.end());
+    if (chunks_.find(chunkOf(pos)) == chunks_.end()) return;
+    set(pos, BlockId::Air);
+}
+
+void World::set(const glm::ivec3& pos, BlockId id) {
+    ChunkCoord coord = chunkOf(pos);
+    chunks_[coord].set(localOf(pos), id);
+    markEdited(coord);
 }
\ No newline at end of file
@@ -1,15 +1,52 @@
 #pragma once
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include "Block.hpp"
+#include "Chunk.hpp"
+#include "../mem/Pool.hpp"
 
 class World {
 public:
-    World(std::vector<Block> blocks);
-    const std::vector<Block>& blocks() const;
+    // Map nodes are pooled like the cells they point at, so chunk churn at the view edge stays off the heap
+    using ChunkMap = std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash, std::equal_to<ChunkCoord>,
+                                        PoolAllocator<std::pair<const ChunkCoord, Chunk>>>;
+
+    BlockId get(const glm::ivec3& pos) const; // Air if empty or not loaded
     BlockHitInfo raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+    // Same results as raycast() for every ray. Rays are walked through the grid in packets of RAY_PACKET lanes
+    // (SoA, branch-free stepping the compiler vectorizes) and large batches are split across threads.
+    // hits must be the same size as rays (std::invalid_argument otherwise).
+    void raycastBatch(std::span<const Ray> rays, std::span<BlockHitInfo> hits) const;
+    static constexpr int RAY_PACKET = 8;
     void add(const Block& block);
     void remove(const glm::ivec3& pos);
 
+    const ChunkMap& chunks() const { return chunks_; }
+    const Chunk* chunk(const ChunkCoord& coord) const;
+    void replaceChunk(const ChunkCoord& coord, const Chunk& chunk); // streamed in; does not mark the chunk dirty
+    void loadChunk(const ChunkCoord& coord, const Chunk& chunk); // read from a save; needs a remesh but not a re-save
+    size_t blockCount() const;
+    uint64_t version() const { return version_; } // changes whenever any cell may have changed
+    // Direct cell access for the block ticker's workers, which may write disjoint chunks concurrently.
+    // Lookup only (never creates a chunk); follow writes with markEdited() once the workers are done.
+    Chunk* chunkForWrite(const ChunkCoord& coord);
+    void markEdited(const ChunkCoord& coord); // needs a remesh and a re-save
+
+    void takeDirtyChunks(std::vector<ChunkCoord>& out); // replaces out with the chunks edited since the last call, i.e. needing a remesh
+    // Copy-on-write copies of every chunk edited since the last snapshot; O(edited chunks) refcount bumps, no cell copies
+    std::vector<std::pair<ChunkCoord, Chunk>> snapshotUnsaved();
+    void discardUnsaved(); // everything so far is already persisted (or reproducible)
+
 private:
-    std::vector<Block> blocks_;
-};
\ No newline at end of file
+    void raycastPacket(const Ray* rays, BlockHitInfo* hits, int count) const;
+    void set(const glm::ivec3& pos, BlockId id);
+    void markDirty(const ChunkCoord& coord);
+
+    ChunkMap chunks_;
+    uint64_t version_ = 0;
+    std::vector<ChunkCoord> dirty_; // a handful per frame: a linear de-dup beats hashing and keeps its capacity
+    std::unordered_set<ChunkCoord, ChunkCoordHash, std::equal_to<ChunkCoord>, PoolAllocator<ChunkCoord>> unsaved_;
+};